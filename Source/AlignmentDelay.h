@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    AlignmentDelay.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Delays a signal to line it up with a path that has latency, and moves to a new
+    delay without a jump.
+
+    When the delay changes, the old and the new delay are read from the same history
+    and crossfaded over one block's worth of samples, the same length OversamplingStage
+    crossfades a factor switch over. A change that arrives mid-fade waits for the fade
+    to finish, so the output never skips. The first delay after a reset is taken up
+    straight away, there's nothing to fade from.
+*/
+class AlignmentDelay
+{
+public:
+    static constexpr int maximumDelayInSamples = 2048;
+
+    AlignmentDelay() = default;
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        delayLine.prepare (spec);
+        fadeLength = juce::jmax (1, static_cast<int> (spec.maximumBlockSize));
+        reset();
+    }
+
+    /** Clears the history and finishes any fade at the latest delay asked for. */
+    void reset() noexcept
+    {
+        delayLine.reset();
+        previousDelay = currentDelay = pendingDelay;
+        fadeRemaining = 0;
+        isFresh = true;
+    }
+
+    void setDelay (float newDelayInSamples) noexcept
+    {
+        pendingDelay = juce::jlimit (0.0f, static_cast<float> (maximumDelayInSamples - 1), newDelayInSamples);
+
+        if (isFresh)
+            previousDelay = currentDelay = pendingDelay;
+    }
+
+    /** The delay the output is settling on, in samples. */
+    float getDelay() const noexcept    { return pendingDelay; }
+
+    void process (juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples = block.getNumSamples();
+        isFresh = false;
+
+        for (size_t start = 0; start < numSamples;)
+        {
+            if (fadeRemaining == 0 && pendingDelay != currentDelay)
+            {
+                previousDelay = currentDelay;
+                currentDelay = pendingDelay;
+                fadeRemaining = fadeLength;
+            }
+
+            if (fadeRemaining == 0)
+            {
+                auto rest = block.getSubBlock (start);
+                delayLine.setDelay (currentDelay);
+                delayLine.process (juce::dsp::ProcessContextReplacing<float> (rest));
+                return;
+            }
+
+            const auto length = juce::jmin (numSamples - start, static_cast<size_t> (fadeRemaining));
+            const auto fadeStart = fadeLength - fadeRemaining;
+            const auto step = 1.0f / static_cast<float> (fadeLength);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = block.getChannelPointer (channel) + start;
+                const auto channelIndex = static_cast<int> (channel);
+
+                for (size_t i = 0; i < length; ++i)
+                {
+                    delayLine.pushSample (channelIndex, data[i]);
+                    const auto previous = delayLine.popSample (channelIndex, previousDelay, false);
+                    const auto next = delayLine.popSample (channelIndex, currentDelay, true);
+                    const auto gain = static_cast<float> (fadeStart + static_cast<int> (i) + 1) * step;
+                    data[i] = previous + gain * (next - previous);
+                }
+            }
+
+            fadeRemaining -= static_cast<int> (length);
+            start += length;
+        }
+    }
+
+private:
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine { maximumDelayInSamples };
+
+    // currentDelay is being faded in from previousDelay while fadeRemaining > 0,
+    // pendingDelay is where it goes next. isFresh until the first block after a reset.
+    float previousDelay = 0.0f, currentDelay = 0.0f, pendingDelay = 0.0f;
+    int fadeLength = 1, fadeRemaining = 0;
+    bool isFresh = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AlignmentDelay)
+};
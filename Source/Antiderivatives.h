@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    Antiderivatives.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+/**
+    Antiderivative anti-aliasing (ADAA) for the distortion curves.
+
+    Instead of evaluating the curve f at each sample, first order ADAA outputs the
+    average of f over the line between the previous and current input, using the
+    closed form first antiderivative F1:
+
+        y[n] = (F1 (x[n]) - F1 (x[n-1])) / (x[n] - x[n-1])
+
+    Second order does the same with the second antiderivative F2 over the last three
+    inputs, which suppresses aliasing further at the cost of one more sample of delay.
+    Both fall back to evaluating f (or F1) at the midpoint when the inputs are too close
+    together for the division to be well conditioned.
+
+    Everything runs in double, the differences of antiderivatives cancel badly in float.
+*/
+namespace ADAA
+{
+    constexpr double illConditionedThreshold = 1.0e-5;
+
+    //==============================================================================
+    /** Hard clip at +-1. */
+    struct HardClip
+    {
+        static double f (double x) noexcept     { return x > 1.0 ? 1.0 : (x < -1.0 ? -1.0 : x); }
+
+        static double F1 (double x) noexcept
+        {
+            const auto a = std::abs (x);
+            return a <= 1.0 ? 0.5 * x * x : a - 0.5;
+        }
+
+        static double F2 (double x) noexcept
+        {
+            return std::abs (x) <= 1.0 ? x * x * x / 6.0
+                                       : std::copysign (0.5 * x * x + 1.0 / 6.0, x) - 0.5 * x;
+        }
+    };
+
+    /** 1.5 * sign (x) * (1 - exp (-|x|)), the exponential soft clip. */
+    struct Exponential
+    {
+        static double f (double x) noexcept     { return std::copysign (1.5 * (1.0 - std::exp (-std::abs (x))), x); }
+
+        static double F1 (double x) noexcept
+        {
+            const auto a = std::abs (x);
+            return 1.5 * (a + std::exp (-a) - 1.0);
+        }
+
+        static double F2 (double x) noexcept
+        {
+            const auto a = std::abs (x);
+            return std::copysign (1.5 * (0.5 * a * a - a - std::exp (-a) + 1.0), x);
+        }
+    };
+
+    /** (2 / pi) * atan (x). */
+    struct ArcTan
+    {
+        static constexpr double scale = 0.63661977236758134308;    // 2 / pi
+
+        static double f (double x) noexcept     { return scale * std::atan (x); }
+
+        static double F1 (double x) noexcept
+        {
+            return scale * (x * std::atan (x) - 0.5 * std::log1p (x * x));
+        }
+
+        static double F2 (double x) noexcept
+        {
+            return scale * (0.5 * (x * x - 1.0) * std::atan (x) + 0.5 * x - 0.5 * x * std::log1p (x * x));
+        }
+    };
+
+    /** 3 * tanh (x / 4), the curve the tubeIsh rational approximation follows. */
+    struct Tanh
+    {
+        static double f (double x) noexcept     { return 3.0 * std::tanh (0.25 * x); }
+
+        // 12 * log (cosh (x / 4)), written to stay finite for large |x|
+        static double F1 (double x) noexcept
+        {
+            const auto u = std::abs (0.25 * x);
+            return 12.0 * (u + std::log1p (std::exp (-2.0 * u)) - 0.69314718055994530942);
+        }
+
+        // 48 * integral of log (cosh (u)) du with u = x / 4, via the dilogarithm
+        static double F2 (double x) noexcept
+        {
+            const auto u = std::abs (0.25 * x);
+            const auto g = 0.5 * u * u - 0.69314718055994530942 * u
+                         + 0.5 * dilogarithmOfMinus (std::exp (-2.0 * u)) + 0.41123351671205660911;    // pi^2 / 24
+            return std::copysign (48.0 * g, x);
+        }
+
+    private:
+        /** Li2 (-w) for w in [0, 1], via the Bernoulli series in log (1 + w). */
+        static double dilogarithmOfMinus (double w) noexcept
+        {
+            // Li2 (z) = sum B_n t^(n + 1) / (n + 1)! with t = -log (1 - z)
+            const auto t = -std::log1p (w);
+            const auto t2 = t * t;
+
+            return t * (1.0 + t * (-0.25 + t * (1.0 / 36.0 + t2 * (-1.0 / 3600.0 + t2 * (1.0 / 211680.0
+                     + t2 * (-1.0 / 10886400.0 + t2 * (1.0 / 526901760.0)))))));
+        }
+    };
+
+    //==============================================================================
+    /** (F2 (x) - F2 (x1)) / (x - x1), or F1 at the midpoint where that's ill conditioned. */
+    template <typename Curve>
+    inline double getDividedDifference (double x, double x1, double F2x, double F2x1) noexcept
+    {
+        const auto delta = x - x1;
+        return std::abs (delta) < illConditionedThreshold ? Curve::F1 (0.5 * (x + x1))
+                                                          : (F2x - F2x1) / delta;
+    }
+
+    /** Per-channel history for the ADAA processors.
+
+        The history is only the previous two inputs, which both orders keep up to date.
+        The antiderivatives at those inputs are cached as well, so each is evaluated once
+        per sample, but the cache is only valid for the curve and order that filled it.
+        Call prepare() before each block so it's rebuilt from x1 and x2 after a mode or
+        order change, or after skip(). */
+    struct State
+    {
+        double x1 = 0.0, x2 = 0.0;      // Previous two inputs
+
+        // Cached for cachedCurve at cachedOrder only
+        double F1x1 = 0.0, F2x1 = 0.0;  // Antiderivatives at x1
+        double d1 = 0.0;                // Divided difference of F2 between x2 and x1
+        double (*cachedCurve) (double) = nullptr;
+        int cachedOrder = 0;
+
+        template <typename Curve>
+        void prepare (int order) noexcept
+        {
+            if (cachedCurve == &Curve::f && cachedOrder == order)
+                return;
+
+            cachedCurve = &Curve::f;
+            cachedOrder = order;
+
+            if (order == 1)
+            {
+                F1x1 = Curve::F1 (x1);
+            }
+            else
+            {
+                F2x1 = Curve::F2 (x1);
+                d1 = getDividedDifference<Curve> (x1, x2, F2x1, Curve::F2 (x2));
+            }
+        }
+
+        /** Moves the history past a block that was shaped some other way. */
+        void skip (const float* input, size_t numSamples) noexcept
+        {
+            if (numSamples == 0)
+                return;
+
+            x2 = numSamples > 1 ? static_cast<double> (input[numSamples - 2]) : x1;
+            x1 = static_cast<double> (input[numSamples - 1]);
+            cachedCurve = nullptr;
+        }
+    };
+
+    template <typename Curve>
+    inline float processFirstOrder (double x, State& state) noexcept
+    {
+        const auto F1x = Curve::F1 (x);
+        const auto delta = x - state.x1;
+
+        const auto y = std::abs (delta) < illConditionedThreshold ? Curve::f (0.5 * (x + state.x1))
+                                                                  : (F1x - state.F1x1) / delta;
+        state.x2 = state.x1;
+        state.x1 = x;
+        state.F1x1 = F1x;
+        return static_cast<float> (y);
+    }
+
+    template <typename Curve>
+    inline float processSecondOrder (double x, State& state) noexcept
+    {
+        const auto F2x = Curve::F2 (x);
+        const auto d0 = getDividedDifference<Curve> (x, state.x1, F2x, state.F2x1);
+
+        double y;
+        const auto span = x - state.x2;
+
+        if (std::abs (span) >= illConditionedThreshold)
+        {
+            y = 2.0 * (d0 - state.d1) / span;
+        }
+        else
+        {
+            // x and x2 coincide, so expand around their midpoint instead
+            const auto xBar = 0.5 * (x + state.x2);
+            const auto deltaBar = xBar - state.x1;
+
+            y = std::abs (deltaBar) < illConditionedThreshold
+                  ? Curve::f (0.5 * (xBar + state.x1))
+                  : 2.0 / deltaBar * (Curve::F1 (xBar) + (state.F2x1 - Curve::F2 (xBar)) / deltaBar);
+        }
+
+        state.d1 = d0;
+        state.x2 = state.x1;
+        state.x1 = x;
+        state.F2x1 = F2x;
+        return static_cast<float> (y);
+    }
+}
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    CurveTable.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+    A transfer curve precomputed into a lookup table, so shaping costs the same few
+    multiply/adds per sample however expensive the curve is to evaluate.
+
+    The table covers the whole real line by indexing on u = x / (1 + |x|), which
+    squeezes +-infinity onto +-1. Resolution is finest around zero where the curves
+    do their work, and every input lands in the table, non-finite ones included. This assumes
+    the curve saturates, which all the distortion modes do and custom curves are
+    made to (they hold their end values).
+
+    2048 floats keep the table in 8KB, aligned to a cache line so a pass over a
+    block touches as few lines as possible. build() measures the interpolation error
+    at seven points between every pair of nodes, so getMaxError() reports the bound
+    for the curve that's actually loaded rather than a generic estimate.
+*/
+class CurveTable
+{
+public:
+    static constexpr int size = 2048;
+
+    enum class Interpolation
+    {
+        linear,
+        cubic
+    };
+
+    CurveTable()
+        : storage (static_cast<size_t> (size + 2) + cacheLineFloats)
+    {
+        // Offset into the storage so the first real node starts on a cache line
+        const auto address = reinterpret_cast<std::uintptr_t> (storage.data() + 1);
+        const auto misalignment = (address / sizeof (float)) % cacheLineFloats;
+        values = storage.data() + (cacheLineFloats - misalignment) % cacheLineFloats;
+    }
+
+    CurveTable (const CurveTable&) = delete;
+    CurveTable& operator= (const CurveTable&) = delete;
+
+    /** Samples the curve into the table. Allocation free, but evaluates the curve
+        around 16000 times, so keep it off the audio thread where possible. */
+    void build (const std::function<float (float)>& curve)
+    {
+        // values[0] and values[size + 1] are guard nodes for the cubic's outer taps
+        for (int i = 0; i < size; ++i)
+            values[i + 1] = curve (toInput (static_cast<float> (i) * step - 1.0f));
+
+        values[0] = values[1];
+        values[size + 1] = values[size];
+
+        maxLinearError = 0.0f;
+        maxCubicError = 0.0f;
+
+        for (int i = 0; i < size - 1; ++i)
+        {
+            for (int eighth = 1; eighth < 8; ++eighth)
+            {
+                const auto fraction = static_cast<float> (eighth) * 0.125f;
+                const auto u = (static_cast<float> (i) + fraction) * step - 1.0f;
+                const auto expected = curve (toInput (u));
+                const auto* node = values + i;
+
+                maxLinearError = std::max (maxLinearError, std::abs (interpolateLinear (node, fraction) - expected));
+                maxCubicError = std::max (maxCubicError, std::abs (interpolateCubic (node, fraction) - expected));
+            }
+        }
+    }
+
+    /** Copies another table's contents without allocating, for handing a table to the audio thread. */
+    void copyFrom (const CurveTable& other) noexcept
+    {
+        std::memcpy (values, other.values, sizeof (float) * static_cast<size_t> (size + 2));
+        maxLinearError = other.maxLinearError;
+        maxCubicError = other.maxCubicError;
+    }
+
+    /** The largest difference from the curve seen anywhere in the table. */
+    float getMaxError (Interpolation interpolation) const noexcept
+    {
+        return interpolation == Interpolation::linear ? maxLinearError : maxCubicError;
+    }
+
+    template <Interpolation interpolation>
+    float processSample (float x) const noexcept
+    {
+        // +-inf would map through inf / inf and NaN straight into the index, so both are
+        // clamped to the largest finite input first. In this argument order NaN lands on the top end.
+        x = std::max (-std::numeric_limits<float>::max(), std::min (std::numeric_limits<float>::max(), x));
+
+        const auto position = (x / (1.0f + std::abs (x)) + 1.0f) * (0.5f * static_cast<float> (size - 1));
+        const auto index = std::min (static_cast<int> (position), size - 2);
+        const auto fraction = position - static_cast<float> (index);
+
+        return interpolation == Interpolation::linear ? interpolateLinear (values + index, fraction)
+                                                      : interpolateCubic (values + index, fraction);
+    }
+
+    template <Interpolation interpolation>
+    void process (float* data, size_t numSamples) const noexcept
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = processSample<interpolation> (data[i]);
+    }
+
+    //==============================================================================
+    /** A curve through (input, output) points, e.g. drawn by the user or imported.
+        Linear between points, odd-symmetric if only positive inputs are given, and
+        held flat beyond the outermost points. */
+    static std::function<float (float)> makeCurveFromPoints (std::vector<std::pair<float, float>> points)
+    {
+        std::sort (points.begin(), points.end());
+
+        if (points.empty())
+            return [] (float) { return 0.0f; };
+
+        if (points.front().first >= 0.0f)
+        {
+            const auto numPositive = points.size();
+
+            for (size_t i = 0; i < numPositive; ++i)
+                if (points[i].first > 0.0f)
+                    points.emplace_back (-points[i].first, -points[i].second);
+
+            std::sort (points.begin(), points.end());
+        }
+
+        return [points] (float x)
+        {
+            if (x <= points.front().first)  return points.front().second;
+            if (x >= points.back().first)   return points.back().second;
+
+            const auto next = std::upper_bound (points.begin(), points.end(), std::make_pair (x, 0.0f),
+                                                [] (const std::pair<float, float>& a, const std::pair<float, float>& b)
+                                                { return a.first < b.first; });
+            const auto& upper = *next;
+            const auto& lower = *(next - 1);
+            const auto fraction = (x - lower.first) / (upper.first - lower.first);
+            return lower.second + fraction * (upper.second - lower.second);
+        };
+    }
+
+private:
+    static constexpr size_t cacheLineFloats = 64 / sizeof (float);
+    static constexpr float step = 2.0f / static_cast<float> (size - 1);
+
+    // Inverse of the u mapping, kept just short of +-1 so the end nodes stay finite
+    static float toInput (float u) noexcept
+    {
+        u = std::max (-0.999999f, std::min (0.999999f, u));
+        return u / (1.0f - std::abs (u));
+    }
+
+    // node points at the guard-offset entry before the interval, so node[1] and node[2] bracket it
+    static float interpolateLinear (const float* node, float fraction) noexcept
+    {
+        return node[1] + fraction * (node[2] - node[1]);
+    }
+
+    // Catmull-Rom through the four nodes around the interval
+    static float interpolateCubic (const float* node, float fraction) noexcept
+    {
+        const auto a = node[0], b = node[1], c = node[2], d = node[3];
+        const auto slopeB = 0.5f * (c - a);
+        const auto slopeC = 0.5f * (d - b);
+        const auto delta = c - b;
+
+        return b + fraction * (slopeB + fraction * (3.0f * delta - 2.0f * slopeB - slopeC
+                                                    + fraction * (slopeB + slopeC - 2.0f * delta)));
+    }
+
+    std::vector<float> storage;
+    float* values = nullptr;
+    float maxLinearError = 0.0f, maxCubicError = 0.0f;
+};
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    DiagnosticsOverlay.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "DiagnosticsOverlay.h"
+
+DiagnosticsOverlay::DiagnosticsOverlay (Telemetry& telemetryToShow)
+    : telemetry (telemetryToShow)
+{
+    setInterceptsMouseClicks (true, false);
+}
+
+void DiagnosticsOverlay::visibilityChanged()
+{
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz (4);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void DiagnosticsOverlay::timerCallback()
+{
+    snapshot = telemetry.getSnapshot();
+    repaint();
+}
+
+void DiagnosticsOverlay::mouseUp (const juce::MouseEvent&)
+{
+    telemetry.resetStatistics();
+    timerCallback();
+}
+
+void DiagnosticsOverlay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black.withAlpha (0.75f));
+
+    auto area = getLocalBounds().reduced (10);
+    const auto lineHeight = 16;
+
+    g.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+
+    auto drawLine = [&] (const juce::String& text, juce::Colour colour)
+    {
+        g.setColour (colour);
+        g.drawText (text, area.removeFromTop (lineHeight), juce::Justification::centredLeft, false);
+    };
+
+    // Green while there's plenty of headroom, red once a block gets near its deadline
+    const auto loadColour = snapshot.peakLoad > 0.7 ? juce::Colours::red
+                          : snapshot.peakLoad > 0.3 ? juce::Colours::orange
+                                                    : juce::Colours::lightgreen;
+
+    drawLine ("DIAGNOSTICS (click to reset peaks)", juce::Colours::white);
+    drawLine (juce::String::formatted ("block   %d samples @ %.0f Hz, %dx oversampling",
+                                       snapshot.lastBlockSize, snapshot.sampleRate, snapshot.oversamplingFactor),
+              juce::Colours::lightgrey);
+    drawLine (juce::String::formatted ("time    avg %.3f ms   peak %.3f ms", snapshot.averageBlockMs, snapshot.peakBlockMs),
+              juce::Colours::lightgrey);
+    drawLine (juce::String::formatted ("load    avg %.1f%%   peak %.1f%% of deadline", snapshot.averageLoad * 100.0, snapshot.peakLoad * 100.0),
+              loadColour);
+
+    area.removeFromTop (lineHeight / 2);
+
+    for (int stage = 0; stage < Telemetry::numStages; ++stage)
+        drawLine (juce::String (Telemetry::getStageName (static_cast<Telemetry::Stage> (stage))).paddedRight (' ', 12)
+                      + juce::String (snapshot.averageStageMs[(size_t) stage], 4) + " ms",
+                  juce::Colours::lightgrey);
+
+    area.removeFromTop (lineHeight / 2);
+    drawLine ("blocks  " + juce::String (snapshot.numBlocks), juce::Colours::grey);
+}
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    DiagnosticsOverlay.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Telemetry.h"
+
+/**
+    Semi-transparent panel showing the processor's telemetry: block time, load against
+    the block deadline, per-stage time and the active oversampling factor.
+
+    Polls the telemetry on a timer only while it's showing, so a hidden overlay costs
+    nothing. Clicking it resets the peaks.
+*/
+class DiagnosticsOverlay : public juce::Component,
+                           private juce::Timer
+{
+public:
+    explicit DiagnosticsOverlay (Telemetry& telemetryToShow);
+
+    void paint (juce::Graphics& g) override;
+    void mouseUp (const juce::MouseEvent& event) override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+
+    Telemetry& telemetry;
+    Telemetry::Snapshot snapshot;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsOverlay)
+};
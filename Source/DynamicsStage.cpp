@@ -0,0 +1,376 @@
+/*
+  ==============================================================================
+
+    DynamicsStage.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "DynamicsStage.h"
+
+juce::StringArray DynamicsStage::getLinkingNames()
+{
+    return { "Unlinked", "Linked Pairs", "Linked All" };
+}
+
+std::vector<int> DynamicsStage::makeChannelGroups (const juce::AudioChannelSet& layout, int numChannels, Linking linking)
+{
+    std::vector<int> groups ((size_t) numChannels);
+    std::iota (groups.begin(), groups.end(), 0);
+
+    if (linking == Linking::all)
+    {
+        std::fill (groups.begin(), groups.end(), 0);
+    }
+    else if (linking == Linking::pairs)
+    {
+        if (layout.size() != numChannels || layout.isDiscreteLayout())
+        {
+            // Nothing to go on but the order, so take the channels two at a time
+            for (int channel = 1; channel < numChannels; channel += 2)
+                groups[(size_t) channel] = channel - 1;
+        }
+        else
+        {
+            // Centre, LFE and anything without a mirror image stay on their own
+            using Type = juce::AudioChannelSet::ChannelType;
+            const std::pair<Type, Type> mirrored[] = {
+                { juce::AudioChannelSet::left,              juce::AudioChannelSet::right },
+                { juce::AudioChannelSet::leftCentre,        juce::AudioChannelSet::rightCentre },
+                { juce::AudioChannelSet::leftSurround,      juce::AudioChannelSet::rightSurround },
+                { juce::AudioChannelSet::leftSurroundSide,  juce::AudioChannelSet::rightSurroundSide },
+                { juce::AudioChannelSet::leftSurroundRear,  juce::AudioChannelSet::rightSurroundRear },
+                { juce::AudioChannelSet::wideLeft,          juce::AudioChannelSet::wideRight },
+                { juce::AudioChannelSet::topFrontLeft,      juce::AudioChannelSet::topFrontRight },
+                { juce::AudioChannelSet::topRearLeft,       juce::AudioChannelSet::topRearRight }
+            };
+
+            for (const auto& pair : mirrored)
+            {
+                const auto first = layout.getChannelIndexForType (pair.first);
+                const auto second = layout.getChannelIndexForType (pair.second);
+
+                if (first >= 0 && second >= 0)
+                    groups[(size_t) juce::jmax (first, second)] = juce::jmin (first, second);
+            }
+        }
+    }
+
+    return groups;
+}
+
+void DynamicsStage::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    preparedSampleRate = spec.sampleRate;
+    maximumBlockSize = static_cast<size_t> (spec.maximumBlockSize);
+
+    envelopes.resize (spec.numChannels);
+
+    // Unlinked until told otherwise
+    channelGroups.resize (spec.numChannels);
+    std::iota (channelGroups.begin(), channelGroups.end(), 0);
+    gains.allocate (maximumBlockSize, true);
+    laneGains.allocate (maximumBlockSize * numLanes, true);
+
+    updateBallistics();
+    reset();
+}
+
+void DynamicsStage::reset()
+{
+    std::fill (envelopes.begin(), envelopes.end(), 0.0f);
+    peakEnvelope = 0.0f;
+}
+
+void DynamicsStage::saveState (State& state) const
+{
+    state.envelopes = envelopes;
+    state.peakEnvelope = peakEnvelope;
+}
+
+void DynamicsStage::restoreState (const State& state) noexcept
+{
+    jassert (state.envelopes.size() == envelopes.size());
+    std::copy (state.envelopes.begin(), state.envelopes.end(), envelopes.begin());
+    peakEnvelope = state.peakEnvelope;
+}
+
+//==============================================================================
+void DynamicsStage::setThreshold (float newThresholdDecibels) noexcept
+{
+    if (newThresholdDecibels == thresholdDecibels)
+        return;
+
+    thresholdDecibels = newThresholdDecibels;
+    thresholdInverse = 1.0f / juce::Decibels::decibelsToGain (thresholdDecibels, -200.0f);
+}
+
+void DynamicsStage::setRatio (float newRatio) noexcept
+{
+    jassert (newRatio >= 1.0f);
+
+    if (newRatio == ratio)
+        return;
+
+    ratio = newRatio;
+    ratioExponent = 1.0f / ratio - 1.0f;
+}
+
+void DynamicsStage::setAttack (float newAttackMs) noexcept
+{
+    if (newAttackMs == attackMs)
+        return;
+
+    attackMs = newAttackMs;
+    updateBallistics();
+}
+
+void DynamicsStage::setRelease (float newReleaseMs) noexcept
+{
+    if (newReleaseMs == releaseMs)
+        return;
+
+    releaseMs = newReleaseMs;
+    updateBallistics();
+}
+
+void DynamicsStage::setChannelGroups (const std::vector<int>& groups) noexcept
+{
+    jassert (groups.size() == channelGroups.size());
+
+    if (groups == channelGroups)
+        return;
+
+    std::copy_n (groups.begin(), juce::jmin (groups.size(), channelGroups.size()), channelGroups.begin());
+
+    // A group's envelope lives at its first channel, so a regrouped channel picks up its new leader's
+    for (size_t channel = 0; channel < channelGroups.size(); ++channel)
+    {
+        jassert (juce::isPositiveAndNotGreaterThan (channelGroups[channel], static_cast<int> (channel)));
+        envelopes[channel] = envelopes[(size_t) channelGroups[channel]];
+    }
+}
+
+void DynamicsStage::setRateScale (float preparedRateOverActualRate) noexcept
+{
+    if (preparedRateOverActualRate == rateScale)
+        return;
+
+    rateScale = preparedRateOverActualRate;
+    updateBallistics();
+}
+
+void DynamicsStage::updateBallistics() noexcept
+{
+    // Same one-pole time constants as juce::dsp::BallisticsFilter, at the rate we actually run at
+    const auto sampleRate = preparedSampleRate / static_cast<double> (rateScale);
+    const auto expFactor = -2.0 * juce::MathConstants<double>::pi * 1000.0 / sampleRate;
+
+    auto coefficient = [expFactor] (float timeMs)
+    {
+        return timeMs < 1.0e-3f ? 0.0f : static_cast<float> (std::exp (expFactor / static_cast<double> (timeMs)));
+    };
+
+    attackCoefficient = coefficient (attackMs);
+    releaseCoefficient = coefficient (releaseMs);
+}
+
+//==============================================================================
+void DynamicsStage::process (juce::dsp::AudioBlock<float>& block, float detectorGain) noexcept
+{
+    const auto numChannels = block.getNumChannels();
+    jassert (block.getNumSamples() <= maximumBlockSize && numChannels <= envelopes.size());
+
+    const auto detectorScale = std::abs (detectorGain);
+    auto peak = 0.0f;
+
+   #if DEETZ_FASTMATH_SIMD
+    // With more than one group, up to four groups run side by side in the lanes of a Vec
+    std::array<size_t, numLanes> leaders {};
+    size_t numLeaders = 0, numGroups = 0;
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        if (channelGroups[channel] == static_cast<int> (channel))
+            ++numGroups;
+
+    if (numGroups > 1)
+    {
+        for (size_t leader = 0; leader < numChannels; ++leader)
+        {
+            if (channelGroups[leader] != static_cast<int> (leader))
+                continue;
+
+            leaders[numLeaders++] = leader;
+
+            if (numLeaders == numLanes)
+            {
+                peak = juce::jmax (peak, processLanes (block, leaders, numLeaders, detectorScale));
+                numLeaders = 0;
+            }
+        }
+
+        if (numLeaders > 0)
+            peak = juce::jmax (peak, processLanes (block, leaders, numLeaders, detectorScale));
+
+        peakEnvelope = peak;
+        return;
+    }
+   #endif
+
+    for (size_t leader = 0; leader < numChannels; ++leader)
+        if (channelGroups[leader] == static_cast<int> (leader))
+            peak = juce::jmax (peak, processGroup (block, leader, detectorScale));
+
+    peakEnvelope = peak;
+}
+
+float DynamicsStage::processGroup (juce::dsp::AudioBlock<float>& block, size_t leader, float detectorScale) noexcept
+{
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+
+    // Pass 0: the group's detector level is its loudest channel, sample by sample
+    juce::FloatVectorOperations::abs (gains.get(), block.getChannelPointer (leader), static_cast<int> (numSamples));
+
+    for (auto channel = leader + 1; channel < numChannels; ++channel)
+    {
+        if (channelGroups[channel] != static_cast<int> (leader))
+            continue;
+
+        const auto* data = block.getChannelPointer (channel);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            gains[i] = juce::jmax (gains[i], std::abs (data[i]));
+    }
+
+    auto envelope = envelopes[leader];
+    auto peak = 0.0f;
+
+    // Pass 1: peak envelope. The only serial part.
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto level = gains[i] * detectorScale;
+        const auto coefficient = level > envelope ? attackCoefficient : releaseCoefficient;
+        envelope = level + coefficient * (envelope - level);
+        gains[i] = envelope;
+        peak = juce::jmax (peak, envelope);
+    }
+
+    envelopes[leader] = envelope;
+
+    // Pass 2: gain curve
+    applyGainCurve (gains.get(), numSamples);
+
+    // Pass 3: apply the same gain to every channel in the group
+    for (auto channel = leader; channel < numChannels; ++channel)
+        if (channelGroups[channel] == static_cast<int> (leader))
+            juce::FloatVectorOperations::multiply (block.getChannelPointer (channel), gains.get(), static_cast<int> (numSamples));
+
+    return peak;
+}
+
+#if DEETZ_FASTMATH_SIMD
+float DynamicsStage::processLanes (juce::dsp::AudioBlock<float>& block, const std::array<size_t, numLanes>& leaders,
+                                   size_t numLeaders, float detectorScale) noexcept
+{
+    using FastMath::Vec;
+    static_assert (Vec::size == numLanes, "One group per lane");
+
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    auto* lanes = laneGains.get();
+
+    // Pass 0: each group's detector level goes into its lane, sample i of lane l at
+    // i * numLanes + l. Unused lanes stay at zero, so they never leave unity gain.
+    std::fill (lanes, lanes + numSamples * numLanes, 0.0f);
+    std::array<float, numLanes> laneEnvelopes {};
+
+    for (size_t lane = 0; lane < numLeaders; ++lane)
+    {
+        const auto leader = leaders[lane];
+        laneEnvelopes[lane] = envelopes[leader];
+
+        for (auto channel = leader; channel < numChannels; ++channel)
+        {
+            if (channelGroups[channel] != static_cast<int> (leader))
+                continue;
+
+            const auto* data = block.getChannelPointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                lanes[i * numLanes + lane] = juce::jmax (lanes[i * numLanes + lane], std::abs (data[i]));
+        }
+    }
+
+    // Pass 1: every group's envelope at once, the same arithmetic as processGroup lane by lane
+    auto envelope = Vec::load (laneEnvelopes.data());
+    auto peak = Vec (0.0f);
+    const Vec scale (detectorScale), attack (attackCoefficient), release (releaseCoefficient);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto level = Vec::load (lanes + i * numLanes) * scale;
+        const auto coefficient = FastMath::select (FastMath::greaterThan (level, envelope), attack, release);
+        envelope = level + coefficient * (envelope - level);
+        envelope.store (lanes + i * numLanes);
+        peak = FastMath::max (peak, envelope);
+    }
+
+    envelope.store (laneEnvelopes.data());
+
+    for (size_t lane = 0; lane < numLeaders; ++lane)
+        envelopes[leaders[lane]] = laneEnvelopes[lane];
+
+    // Pass 2: the curve doesn't care which lane a sample is in
+    applyGainCurve (lanes, numSamples * numLanes);
+
+    // Pass 3: each channel takes its group's lane
+    for (size_t lane = 0; lane < numLeaders; ++lane)
+    {
+        for (auto channel = leaders[lane]; channel < numChannels; ++channel)
+        {
+            if (channelGroups[channel] != static_cast<int> (leaders[lane]))
+                continue;
+
+            auto* data = block.getChannelPointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                data[i] *= lanes[i * numLanes + lane];
+        }
+    }
+
+    std::array<float, numLanes> lanePeaks;
+    peak.store (lanePeaks.data());
+    return *std::max_element (lanePeaks.begin(), lanePeaks.end());
+}
+#endif
+
+void DynamicsStage::applyGainCurve (float* data, size_t numSamples) const noexcept
+{
+    // Below threshold the ratio of envelope to threshold is clamped to 1, which makes
+    // the power come out at exactly unity
+    if (useFastApproximations)
+    {
+        const auto exponent = ratioExponent, inverse = thresholdInverse;
+
+        FastMath::apply (data, numSamples, [exponent, inverse] (auto envelopeLevel)
+        {
+            using Value = decltype (envelopeLevel);
+            return FastMath::exp2 (Value (exponent) * FastMath::log2 (FastMath::max (Value (1.0f), envelopeLevel * Value (inverse))));
+        });
+    }
+    else
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = std::exp (ratioExponent * std::log (juce::jmax (1.0f, data[i] * thresholdInverse)));
+    }
+}
+
+float DynamicsStage::getGainReductionDecibels() const noexcept
+{
+    // Same curve as pass 2, at the loudest point of the block
+    const auto gain = std::exp (ratioExponent * std::log (juce::jmax (1.0f, peakEnvelope * thresholdInverse)));
+    return -juce::Decibels::gainToDecibels (gain, -100.0f);
+}
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    DynamicsStage.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+/**
+    Peak compressor that works a block at a time.
+
+    Behaves like juce::dsp::Compressor (peak ballistics, hard knee), but instead of
+    one processSample call per sample it makes three passes over each channel: the
+    envelope recursion, the gain curve, then a vector multiply. Only the first pass
+    is inherently serial. The gain curve runs four samples at a time through
+    FastMath's log2 and exp2, within 6e-6 of the exact gain (5e-5dB); with
+    fast approximations off it uses std::exp and std::log, a sample at a time.
+
+    Settings are cached and the coefficients are only recalculated when one of them
+    actually changes, so it's fine to push the parameter values every block.
+
+    Channels can be linked into groups that share one envelope, driven by the loudest
+    channel in the group, so a stereo pair or a surround pair ducks together instead of
+    the image wandering. Unlinked is just every channel in a group of its own. Where
+    there's more than one group and FastMath has a Vec, the groups are packed four to
+    a Vec, one per lane, so the envelope recursion runs for four groups at once.
+*/
+class DynamicsStage
+{
+public:
+    enum class Linking
+    {
+        unlinked = 0,    // Every channel on its own
+        pairs,           // Left/right pairs of the layout, or neighbouring channels of a discrete one
+        all              // One envelope for the whole bus
+    };
+
+    static juce::StringArray getLinkingNames();
+
+    /** Builds the groups for setChannelGroups() from a bus layout. Allocates. */
+    static std::vector<int> makeChannelGroups (const juce::AudioChannelSet& layout, int numChannels, Linking linking);
+
+    DynamicsStage() = default;
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void setThreshold (float newThresholdDecibels) noexcept;
+    void setRatio (float newRatio) noexcept;
+    void setAttack (float newAttackMs) noexcept;
+    void setRelease (float newReleaseMs) noexcept;
+
+    /** Links channels together. groups[c] is the first channel of the group channel c
+        belongs to, so { 0, 0, 2, 3 } links the first two channels and leaves the rest
+        alone. Copies into storage sized in prepare(), so it's safe on the audio thread. */
+    void setChannelGroups (const std::vector<int>& groups) noexcept;
+
+    /** Compensates the time constants when running at a lower rate than prepared for,
+        as with Waveshaper::setRateScale. */
+    void setRateScale (float preparedRateOverActualRate) noexcept;
+
+    /** Chooses the FastMath gain curve over the exact one, as with
+        Waveshaper::setUseFastApproximations. */
+    void setUseFastApproximations (bool shouldUseFast) noexcept    { useFastApproximations = shouldUseFast; }
+
+    /** Compresses the block in place. detectorGain scales the level the envelope sees
+        without touching the audio, for when a gain that comes later in the chain
+        (like drive) should still count towards the threshold. */
+    void process (juce::dsp::AudioBlock<float>& block, float detectorGain = 1.0f) noexcept;
+
+    /** The deepest gain reduction in the last process() call, in positive decibels. Worked
+        out from the loudest envelope when asked, so metering costs nothing until it's read. */
+    float getGainReductionDecibels() const noexcept;
+
+    /** The envelopes, for running the stage twice over the same stretch of time, see
+        FilterStage::State. The first save into a State allocates. */
+    struct State
+    {
+        std::vector<float> envelopes;
+        float peakEnvelope = 0.0f;
+    };
+
+    void saveState (State& state) const;
+    void restoreState (const State& state) noexcept;
+
+private:
+    static constexpr size_t numLanes = 4;
+
+    void updateBallistics() noexcept;
+    float processGroup (juce::dsp::AudioBlock<float>& block, size_t leader, float detectorScale) noexcept;
+    void applyGainCurve (float* data, size_t numSamples) const noexcept;
+
+   #if DEETZ_FASTMATH_SIMD
+    float processLanes (juce::dsp::AudioBlock<float>& block, const std::array<size_t, numLanes>& leaders,
+                        size_t numLeaders, float detectorScale) noexcept;
+   #endif
+
+    double preparedSampleRate = 44100.0;
+    float rateScale = 1.0f;
+
+    float thresholdDecibels = 0.0f, ratio = 1.0f, attackMs = 1.0f, releaseMs = 100.0f;
+    float thresholdInverse = 1.0f, ratioExponent = 0.0f;
+    float attackCoefficient = 0.0f, releaseCoefficient = 0.0f;
+    bool useFastApproximations = true;
+
+    std::vector<float> envelopes;
+    float peakEnvelope = 0.0f;
+    std::vector<int> channelGroups;
+    juce::HeapBlock<float> gains;
+    juce::HeapBlock<float> laneGains;    // numLanes groups interleaved, sample by sample
+    size_t maximumBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicsStage)
+};
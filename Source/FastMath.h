@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define DEETZ_FASTMATH_SSE2 1
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+ #include <arm_neon.h>
+ #define DEETZ_FASTMATH_NEON 1
+#endif
+
+#if DEETZ_FASTMATH_SSE2 || DEETZ_FASTMATH_NEON
+ #define DEETZ_FASTMATH_SIMD 1
+#else
+ #define DEETZ_FASTMATH_SIMD 0
+#endif
+
+/**
+    Branch-free approximations of the transcendental functions used by the
+    distortion curves, for single floats and for FastMath::Vec.
+
+    Vec holds four floats in an SSE2 or AArch64 NEON register and is written with
+    intrinsics, as the compiler won't vectorise these loops by itself without
+    -ffast-math. Every function is a template over float and Vec built from the
+    same few operations (min, abs, select, copySign and the arithmetic operators),
+    so a block goes through four lanes at a time and the scalar tail gives exactly
+    the same results. Other targets use the scalar code throughout. The std::
+    functions remain the reference, and the path used when exact output is wanted.
+
+    Stated max absolute errors, measured over the full float range of the input:
+        expMinusAbs     < 1.0e-6
+        atan            < 2.0e-6 rad
+        log2            < 8.0e-6, for positive normal floats
+        exp2            < 2.0e-7 relative, for x in [-126, 127]
+    The benchmark harness's --accuracy check holds them (and the kernels built on
+    them) to these bounds.
+*/
+namespace FastMath
+{
+    //==============================================================================
+    // The scalar side of the operations. Plain comparisons rather than std::fmin so
+    // nothing ends up as a libm call, ordered like minps/maxps so a NaN gives b.
+    inline float min (float a, float b) noexcept                 { return a < b ? a : b; }
+    inline float max (float a, float b) noexcept                 { return a > b ? a : b; }
+    inline float abs (float x) noexcept                          { return std::fabs (x); }
+    inline float copySign (float magnitude, float sign) noexcept { return std::copysign (magnitude, sign); }
+    inline bool greaterThan (float a, float b) noexcept          { return a > b; }
+    inline float select (bool condition, float a, float b) noexcept    { return condition ? a : b; }
+
+    // The float's bits, for splitting off and putting back the exponent. The
+    // exponent and mantissa functions expect a positive normal float.
+    inline int32_t toBits (float x) noexcept          { int32_t bits; std::memcpy (&bits, &x, sizeof (bits)); return bits; }
+    inline float fromBits (int32_t bits) noexcept     { float x; std::memcpy (&x, &bits, sizeof (x)); return x; }
+
+    inline float exponentOf (float x) noexcept        { return static_cast<float> ((toBits (x) >> 23) - 127); }
+    inline float mantissaOf (float x) noexcept        { return fromBits ((toBits (x) & 0x007fffff) | 0x3f800000); }
+
+    /** x times 2^n, for a whole n that keeps the result a normal float. */
+    inline float scaleByPowerOfTwo (float x, float n) noexcept    { return fromBits (toBits (x) + (static_cast<int32_t> (n) << 23)); }
+
+    inline float floor (float x) noexcept
+    {
+        const auto truncated = static_cast<float> (static_cast<int32_t> (x));
+        return truncated > x ? truncated - 1.0f : truncated;
+    }
+
+   #if DEETZ_FASTMATH_SIMD
+    //==============================================================================
+    /** Four floats in one register. Comparisons return a Vec whose lanes are all ones
+        or all zeros, for select(). */
+    struct Vec
+    {
+        static constexpr size_t size = 4;
+
+       #if DEETZ_FASTMATH_SSE2
+        using Native = __m128;
+       #else
+        using Native = float32x4_t;
+       #endif
+
+        Vec (float x) noexcept;
+        explicit Vec (Native v) noexcept : value (v) {}
+
+        static Vec load (const float* source) noexcept;
+        void store (float* destination) const noexcept;
+
+        Native value;
+    };
+
+   #if DEETZ_FASTMATH_SSE2
+    inline Vec::Vec (float x) noexcept : value (_mm_set1_ps (x)) {}
+    inline Vec Vec::load (const float* source) noexcept         { return Vec (_mm_loadu_ps (source)); }
+    inline void Vec::store (float* destination) const noexcept  { _mm_storeu_ps (destination, value); }
+
+    inline Vec operator+ (Vec a, Vec b) noexcept    { return Vec (_mm_add_ps (a.value, b.value)); }
+    inline Vec operator- (Vec a, Vec b) noexcept    { return Vec (_mm_sub_ps (a.value, b.value)); }
+    inline Vec operator* (Vec a, Vec b) noexcept    { return Vec (_mm_mul_ps (a.value, b.value)); }
+    inline Vec operator/ (Vec a, Vec b) noexcept    { return Vec (_mm_div_ps (a.value, b.value)); }
+
+    inline Vec min (Vec a, Vec b) noexcept          { return Vec (_mm_min_ps (a.value, b.value)); }
+    inline Vec max (Vec a, Vec b) noexcept          { return Vec (_mm_max_ps (a.value, b.value)); }
+    inline Vec greaterThan (Vec a, Vec b) noexcept  { return Vec (_mm_cmpgt_ps (a.value, b.value)); }
+
+    inline Vec select (Vec mask, Vec a, Vec b) noexcept
+    {
+        return Vec (_mm_or_ps (_mm_and_ps (mask.value, a.value), _mm_andnot_ps (mask.value, b.value)));
+    }
+
+    inline Vec abs (Vec x) noexcept
+    {
+        return Vec (_mm_andnot_ps (_mm_set1_ps (-0.0f), x.value));
+    }
+
+    inline Vec copySign (Vec magnitude, Vec sign) noexcept
+    {
+        const auto signBit = _mm_set1_ps (-0.0f);
+        return Vec (_mm_or_ps (_mm_andnot_ps (signBit, magnitude.value), _mm_and_ps (signBit, sign.value)));
+    }
+
+    inline Vec exponentOf (Vec x) noexcept
+    {
+        const auto biased = _mm_srli_epi32 (_mm_castps_si128 (x.value), 23);
+        return Vec (_mm_cvtepi32_ps (_mm_sub_epi32 (biased, _mm_set1_epi32 (127))));
+    }
+
+    inline Vec mantissaOf (Vec x) noexcept
+    {
+        const auto mantissaBits = _mm_castsi128_ps (_mm_set1_epi32 (0x007fffff));
+        return Vec (_mm_or_ps (_mm_and_ps (x.value, mantissaBits), _mm_set1_ps (1.0f)));
+    }
+
+    inline Vec scaleByPowerOfTwo (Vec x, Vec n) noexcept
+    {
+        const auto exponent = _mm_slli_epi32 (_mm_cvttps_epi32 (n.value), 23);
+        return Vec (_mm_castsi128_ps (_mm_add_epi32 (_mm_castps_si128 (x.value), exponent)));
+    }
+
+    // SSE2 has no round-down, so truncate and step back a lane that went up
+    inline Vec floor (Vec x) noexcept
+    {
+        const auto truncated = _mm_cvtepi32_ps (_mm_cvttps_epi32 (x.value));
+        const auto wentUp = _mm_cmpgt_ps (truncated, x.value);
+        return Vec (_mm_sub_ps (truncated, _mm_and_ps (wentUp, _mm_set1_ps (1.0f))));
+    }
+   #else
+    inline Vec::Vec (float x) noexcept : value (vdupq_n_f32 (x)) {}
+    inline Vec Vec::load (const float* source) noexcept         { return Vec (vld1q_f32 (source)); }
+    inline void Vec::store (float* destination) const noexcept  { vst1q_f32 (destination, value); }
+
+    inline Vec operator+ (Vec a, Vec b) noexcept    { return Vec (vaddq_f32 (a.value, b.value)); }
+    inline Vec operator- (Vec a, Vec b) noexcept    { return Vec (vsubq_f32 (a.value, b.value)); }
+    inline Vec operator* (Vec a, Vec b) noexcept    { return Vec (vmulq_f32 (a.value, b.value)); }
+    inline Vec operator/ (Vec a, Vec b) noexcept    { return Vec (vdivq_f32 (a.value, b.value)); }
+
+    // minnm/maxnm pick the number over a NaN, like the scalar versions' second argument
+    inline Vec min (Vec a, Vec b) noexcept          { return Vec (vminnmq_f32 (a.value, b.value)); }
+    inline Vec max (Vec a, Vec b) noexcept          { return Vec (vmaxnmq_f32 (a.value, b.value)); }
+    inline Vec greaterThan (Vec a, Vec b) noexcept  { return Vec (vreinterpretq_f32_u32 (vcgtq_f32 (a.value, b.value))); }
+
+    inline Vec select (Vec mask, Vec a, Vec b) noexcept
+    {
+        return Vec (vbslq_f32 (vreinterpretq_u32_f32 (mask.value), a.value, b.value));
+    }
+
+    inline Vec abs (Vec x) noexcept                 { return Vec (vabsq_f32 (x.value)); }
+
+    inline Vec copySign (Vec magnitude, Vec sign) noexcept
+    {
+        return Vec (vbslq_f32 (vdupq_n_u32 (0x80000000u), sign.value, magnitude.value));
+    }
+
+    inline Vec exponentOf (Vec x) noexcept
+    {
+        const auto biased = vreinterpretq_s32_u32 (vshrq_n_u32 (vreinterpretq_u32_f32 (x.value), 23));
+        return Vec (vcvtq_f32_s32 (vsubq_s32 (biased, vdupq_n_s32 (127))));
+    }
+
+    inline Vec mantissaOf (Vec x) noexcept
+    {
+        const auto bits = vandq_u32 (vreinterpretq_u32_f32 (x.value), vdupq_n_u32 (0x007fffffu));
+        return Vec (vreinterpretq_f32_u32 (vorrq_u32 (bits, vdupq_n_u32 (0x3f800000u))));
+    }
+
+    inline Vec scaleByPowerOfTwo (Vec x, Vec n) noexcept
+    {
+        const auto exponent = vshlq_n_s32 (vcvtq_s32_f32 (n.value), 23);
+        return Vec (vreinterpretq_f32_s32 (vaddq_s32 (vreinterpretq_s32_f32 (x.value), exponent)));
+    }
+
+    inline Vec floor (Vec x) noexcept               { return Vec (vrndmq_f32 (x.value)); }
+   #endif
+   #endif
+
+    //==============================================================================
+    /** Returns exp (-|x|). */
+    template <typename Value>
+    inline Value expMinusAbs (Value x) noexcept
+    {
+        // Beyond 16 the result is below 1.2e-7, so the curve is flat to float precision
+        const Value a = min (abs (x), Value (16.0f)) * Value (1.0f / 16.0f);
+
+        // exp (-a) on [0, 1] by Taylor series, then raised to the 16th power
+        Value y = Value (1.0f) - a * (Value (1.0f) - a * (Value (0.5f) - a * (Value (1.0f / 6.0f) - a * (Value (1.0f / 24.0f)
+                                - a * (Value (1.0f / 120.0f) - a * Value (1.0f / 720.0f))))));
+        y = y * y;
+        y = y * y;
+        y = y * y;
+        y = y * y;
+        return y;
+    }
+
+    /** Returns atan (x). */
+    template <typename Value>
+    inline Value atan (Value x) noexcept
+    {
+        const Value a = abs (x);
+        const auto invert = greaterThan (a, Value (1.0f));
+
+        // Both sides are worked out and one selected, a lane at 0 divides to inf in the unused side
+        const Value z = select (invert, Value (1.0f) / a, a);
+        const Value z2 = z * z;
+
+        // Minimax polynomial for atan on [0, 1]
+        const Value p = z * (Value (0.99997726f) + z2 * (Value (-0.33262347f) + z2 * (Value (0.19354346f) + z2 * (Value (-0.11643287f)
+                          + z2 * (Value (0.05265332f) + z2 * Value (-0.01172120f))))));
+
+        const Value r = select (invert, Value (1.57079632679f) - p, p);
+        return copySign (r, x);
+    }
+
+    /** Returns log2 (x), for a positive normal x. */
+    template <typename Value>
+    inline Value log2 (Value x) noexcept
+    {
+        // Minimax polynomial for log2 (1 + m) on [0, 1), added to the exponent
+        const Value m = mantissaOf (x) - Value (1.0f);
+        const Value p = m * (Value (1.44255315f) + m * (Value (-0.71828192f) + m * (Value (0.45827079f) + m * (Value (-0.27953811f)
+                          + m * (Value (0.12345146f) + m * Value (-0.02645744f))))));
+        return exponentOf (x) + p;
+    }
+
+    /** Returns 2^x, for x in [-126, 127]. Outside that it's held at the ends rather than
+        going denormal or infinite. */
+    template <typename Value>
+    inline Value exp2 (Value x) noexcept
+    {
+        const Value clamped = max (min (x, Value (127.0f)), Value (-126.0f));
+        const Value n = floor (clamped);
+        const Value f = clamped - n;
+
+        // Minimax polynomial for 2^f on [0, 1), then n goes straight into the exponent
+        const Value p = Value (1.0f) + f * (Value (0.69315247f) + f * (Value (0.24015281f) + f * (Value (0.05583593f)
+                          + f * (Value (0.00897338f) + f * Value (0.00188530f)))));
+        return scaleByPowerOfTwo (p, n);
+    }
+
+    /** Applies function across a buffer, Vec::size samples at a time where the target has
+        a Vec, with a scalar tail. function must take and return both float and Vec,
+        e.g. a generic lambda calling the templates above. */
+    template <typename Function>
+    inline void apply (float* data, size_t numSamples, Function&& function) noexcept
+    {
+        size_t i = 0;
+
+       #if DEETZ_FASTMATH_SIMD
+        for (; i + Vec::size <= numSamples; i += Vec::size)
+            function (Vec::load (data + i)).store (data + i);
+       #endif
+
+        for (; i < numSamples; ++i)
+            data[i] = function (data[i]);
+    }
+}
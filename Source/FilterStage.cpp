@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    FilterStage.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "FilterStage.h"
+
+juce::StringArray FilterStage::getPlacementNames()
+{
+    return { "Pre-Drive (Oversampled)", "Pre-Drive", "Post-Drive", "Pre + Post-Drive" };
+}
+
+FilterStage::FilterStage()
+{
+    highPass.svf.setType (juce::dsp::StateVariableTPTFilterType::highpass);
+    lowPass.svf.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+
+    highPassCutoff.setCurrentAndTargetValue (highPassOffFrequency);
+    lowPassCutoff.setCurrentAndTargetValue (lowPassOffFrequency);
+}
+
+void FilterStage::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    highPass.svf.prepare (spec);
+    lowPass.svf.prepare (spec);
+
+    preparedSampleRate = spec.sampleRate;
+    fadeBuffer.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    fadeLength = juce::jmax (1, juce::roundToInt (spec.sampleRate * fadeSeconds));
+
+    // Force the first update through
+    highPass.currentCutoff = lowPass.currentCutoff = 0.0f;
+    reset();
+}
+
+void FilterStage::reset()
+{
+    for (auto* filter : { &highPass, &lowPass })
+    {
+        filter->svf.reset();
+        filter->fadeRemaining = 0;
+    }
+
+    highPassCutoff.setCurrentAndTargetValue (highPassCutoff.getTargetValue());
+    lowPassCutoff.setCurrentAndTargetValue (lowPassCutoff.getTargetValue());
+}
+
+void FilterStage::saveState (State& state) const
+{
+    state.highPass = highPass;
+    state.lowPass = lowPass;
+    state.highPassCutoff = highPassCutoff;
+    state.lowPassCutoff = lowPassCutoff;
+}
+
+void FilterStage::restoreState (const State& state) noexcept
+{
+    highPass = state.highPass;
+    lowPass = state.lowPass;
+    highPassCutoff = state.highPassCutoff;
+    lowPassCutoff = state.lowPassCutoff;
+}
+
+void FilterStage::setRateScale (float preparedRateOverActualRate) noexcept
+{
+    if (preparedRateOverActualRate == rateScale)
+        return;
+
+    rateScale = preparedRateOverActualRate;
+    highPass.currentCutoff = lowPass.currentCutoff = 0.0f;
+}
+
+void FilterStage::resetSmoothing (double actualSampleRate)
+{
+    highPassCutoff.reset (actualSampleRate, 0.05);
+    lowPassCutoff.reset (actualSampleRate, 0.05);
+    fadeLength = juce::jmax (1, juce::roundToInt (actualSampleRate * fadeSeconds));
+
+    for (auto* filter : { &highPass, &lowPass })
+        filter->fadeRemaining = juce::jmin (filter->fadeRemaining, fadeLength);
+}
+
+void FilterStage::setCutoffs (float highPassHz, float lowPassHz) noexcept
+{
+    highPassCutoff.setTargetValue (highPassHz);
+    lowPassCutoff.setTargetValue (lowPassHz);
+}
+
+//==============================================================================
+void FilterStage::updateCoefficients (float highPassHz, float lowPassHz, bool shouldFade) noexcept
+{
+    updateFilter (highPass, highPassHz, highPassHz > highPassOffFrequency, shouldFade);
+    updateFilter (lowPass, lowPassHz, lowPassHz < lowPassOffFrequency, shouldFade);
+}
+
+void FilterStage::updateFilter (Filter& filter, float cutoffHz, bool shouldBeActive, bool shouldFade) noexcept
+{
+    // setCutoffFrequency recalculates a tan() every call, so only make it when something moved
+    if (cutoffHz == filter.currentCutoff)
+        return;
+
+    filter.currentCutoff = cutoffHz;
+
+    if (shouldBeActive != filter.active)
+    {
+        // Out of use and fully faded out, so its state is stale. Whatever it outputs first is
+        // faded out anyway, so starting it clean doesn't click.
+        if (shouldBeActive && filter.fadeRemaining == 0)
+            filter.svf.reset();
+
+        // Turning round mid-fade carries on from the current gain
+        filter.fadeRemaining = shouldFade ? fadeLength - filter.fadeRemaining : 0;
+        filter.active = shouldBeActive;
+    }
+
+    // The cutoff only goes above 0.45x the running rate with the oversampling turned down
+    if (filter.active)
+    {
+        const auto maxCutoffHz = 0.45f * static_cast<float> (preparedSampleRate) / rateScale;
+        filter.svf.setCutoffFrequency (juce::jmin (cutoffHz, maxCutoffHz) * rateScale);
+    }
+}
+
+void FilterStage::processFilter (Filter& filter, juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (filter.fadeRemaining == 0)
+    {
+        if (filter.active)
+            filter.svf.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+        return;
+    }
+
+    // Crossfade between the input and the filtered block, towards whichever is now in use
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    jassert (numChannels <= static_cast<size_t> (fadeBuffer.getNumChannels())
+             && numSamples <= static_cast<size_t> (fadeBuffer.getNumSamples()));
+
+    auto input = juce::dsp::AudioBlock<float> (fadeBuffer).getSubBlock (0, numSamples).getSubsetChannelBlock (0, numChannels);
+    input.copyFrom (block);
+    filter.svf.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+    const auto fadeStart = fadeLength - filter.fadeRemaining;
+    const auto step = 1.0f / static_cast<float> (fadeLength);
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* out = block.getChannelPointer (channel);
+        const auto* in = input.getChannelPointer (channel);
+
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            const auto progress = juce::jlimit (0.0f, 1.0f, static_cast<float> (fadeStart + static_cast<int> (sample) + 1) * step);
+            const auto gain = filter.active ? progress : 1.0f - progress;
+            out[sample] = in[sample] + gain * (out[sample] - in[sample]);
+        }
+    }
+
+    filter.fadeRemaining = juce::jmax (0, filter.fadeRemaining - static_cast<int> (numSamples));
+}
+
+void FilterStage::processFilters (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    processFilter (highPass, block);
+    processFilter (lowPass, block);
+}
+
+void FilterStage::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (! highPassCutoff.isSmoothing() && ! lowPassCutoff.isSmoothing())
+    {
+        // Still cutoffs only change here after a reset, which has nothing to fade from
+        updateCoefficients (highPassCutoff.getTargetValue(), lowPassCutoff.getTargetValue(), false);
+        processFilters (block);
+        return;
+    }
+
+    // Cutoffs are moving, so the coefficients follow the ramp every few samples
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+
+    for (int start = 0; start < numSamples; start += updateInterval)
+    {
+        const auto length = juce::jmin (updateInterval, numSamples - start);
+        updateCoefficients (highPassCutoff.skip (length), lowPassCutoff.skip (length), true);
+
+        auto subBlock = block.getSubBlock (static_cast<size_t> (start), static_cast<size_t> (length));
+        processFilters (subBlock);
+    }
+}
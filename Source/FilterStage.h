@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    FilterStage.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    The highpass/lowpass pair that shapes the tone around the distortion.
+
+    Cutoffs are smoothed inside the stage. Coefficients are only recalculated when a
+    cutoff has actually moved: every updateInterval samples while a cutoff ramps, and
+    not at all while it's still. Cutoffs are kept below 0.45x the rate the stage is
+    actually running at, whatever the oversampling factor.
+
+    A filter whose cutoff sits at the end of its range (20Hz highpass, 20kHz lowpass)
+    is skipped entirely. When a ramp takes it out of or back into use, it crossfades
+    with its own input over fadeSeconds instead of switching. One coming back in starts
+    from a clean state, which can't click as it's faded out at that point.
+*/
+class FilterStage
+{
+public:
+    // Matches the indices of the FILTERPLACEMENT parameter
+    enum class Placement
+    {
+        preDriveOversampled = 0,
+        preDrive,
+        postDrive,
+        preAndPostDrive
+    };
+
+    static juce::StringArray getPlacementNames();
+
+    static constexpr float highPassOffFrequency = 20.0f;
+    static constexpr float lowPassOffFrequency = 20000.0f;
+
+    FilterStage();
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the filter state and jumps the cutoffs straight to their targets. */
+    void reset();
+
+    /** Compensates the cutoffs when running at a lower rate than prepared for, as with
+        Waveshaper::setRateScale. */
+    void setRateScale (float preparedRateOverActualRate) noexcept;
+
+    /** Re-times the cutoff smoothing for the rate process() is called at, and snaps to the targets. */
+    void resetSmoothing (double actualSampleRate);
+
+    void setCutoffs (float highPassHz, float lowPassHz) noexcept;
+
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    struct Filter
+    {
+        juce::dsp::StateVariableTPTFilter<float> svf;
+        float currentCutoff = 0.0f;
+        bool active = false;
+        int fadeRemaining = 0;      // Samples left of the crossfade since active last changed
+    };
+
+    /** Everything process() carries from one block to the next, so a caller can run the
+        stage twice over the same stretch of time, as OversamplingStage's crossfades do. */
+    struct State
+    {
+        Filter highPass, lowPass;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> highPassCutoff, lowPassCutoff;
+    };
+
+    /** The first save into a State sizes it and allocates, so do that from prepareToPlay.
+        After that saving and restoring are only copies. */
+    void saveState (State& state) const;
+    void restoreState (const State& state) noexcept;
+
+private:
+    void updateCoefficients (float highPassHz, float lowPassHz, bool shouldFade) noexcept;
+    void updateFilter (Filter& filter, float cutoffHz, bool shouldBeActive, bool shouldFade) noexcept;
+    void processFilter (Filter& filter, juce::dsp::AudioBlock<float>& block) noexcept;
+    void processFilters (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    Filter highPass, lowPass;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> highPassCutoff, lowPassCutoff;
+
+    double preparedSampleRate = 44100.0;
+    float rateScale = 1.0f;
+
+    // Holds a filter's input while it crossfades in or out
+    juce::AudioBuffer<float> fadeBuffer;
+    int fadeLength = 1;
+
+    // How many samples the filters run between coefficient updates while a cutoff moves
+    static constexpr int updateInterval = 32;
+    static constexpr double fadeSeconds = 0.005;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilterStage)
+};
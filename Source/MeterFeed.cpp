@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    MeterFeed.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "MeterFeed.h"
+
+void MeterFeed::removeReader() noexcept
+{
+    const auto previousReaders = numReaders.fetch_sub (1, std::memory_order_relaxed);
+    jassert (previousReaders > 0);    // Every removeReader needs an addReader before it
+    juce::ignoreUnused (previousReaders);
+}
+
+void MeterFeed::measure (const juce::AudioBuffer<float>& buffer, float& peak, float& rms,
+                         std::array<float, maxScopePoints>& scope, int& numScopePoints) noexcept
+{
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = juce::jmin (buffer.getNumSamples(), maxScopePoints * scopeDecimation);
+
+    peak = 0.0f;
+    auto sumOfSquares = 0.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        peak = juce::jmax (peak, buffer.getMagnitude (channel, 0, numSamples));
+        const auto channelRms = buffer.getRMSLevel (channel, 0, numSamples);
+        sumOfSquares += channelRms * channelRms;
+    }
+
+    rms = numChannels > 0 ? std::sqrt (sumOfSquares / static_cast<float> (numChannels)) : 0.0f;
+
+    // The scope shows the first two channels summed to mono, keeping the biggest
+    // excursion of each group so decimation doesn't shave the peaks off
+    const auto numScopeChannels = juce::jmin (numChannels, 2);
+    const auto scopeGain = numScopeChannels > 0 ? 1.0f / static_cast<float> (numScopeChannels) : 0.0f;
+    numScopePoints = (numSamples + scopeDecimation - 1) / scopeDecimation;
+
+    for (int point = 0; point < numScopePoints; ++point)
+    {
+        const auto start = point * scopeDecimation;
+        const auto end = juce::jmin (start + scopeDecimation, numSamples);
+        auto largest = 0.0f;
+
+        for (int i = start; i < end; ++i)
+        {
+            auto sample = 0.0f;
+
+            for (int channel = 0; channel < numScopeChannels; ++channel)
+                sample += buffer.getSample (channel, i);
+
+            sample *= scopeGain;
+
+            if (std::abs (sample) > std::abs (largest))
+                largest = sample;
+        }
+
+        scope[(size_t) point] = largest;
+    }
+}
+
+//==============================================================================
+void MeterFeed::measureInput (const juce::AudioBuffer<float>& buffer) noexcept
+{
+    measure (buffer, pending.inputPeak, pending.inputRms, pending.scopeInput, pending.numScopePoints);
+}
+
+void MeterFeed::measureOutput (const juce::AudioBuffer<float>& buffer, float gainReductionDecibels) noexcept
+{
+    measure (buffer, pending.outputPeak, pending.outputRms, pending.scopeOutput, pending.numScopePoints);
+    pending.gainReductionDecibels = gainReductionDecibels;
+
+    const auto scope = fifo.write (1);
+
+    if (scope.blockSize1 > 0)
+        ring[(size_t) scope.startIndex1] = pending;
+}
+
+//==============================================================================
+int MeterFeed::popFrames (const std::function<void (const Frame&)>& callback)
+{
+    const auto scope = fifo.read (fifo.getNumReady());
+
+    for (int i = scope.startIndex1; i < scope.startIndex1 + scope.blockSize1; ++i)
+        callback (ring[(size_t) i]);
+
+    for (int i = scope.startIndex2; i < scope.startIndex2 + scope.blockSize2; ++i)
+        callback (ring[(size_t) i]);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
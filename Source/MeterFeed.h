@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    MeterFeed.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Carries level, gain reduction and scope data from the audio thread to the editor.
+
+    The audio thread measures each sub-block on its way in and on its way out and
+    pushes one small frame per sub-block into a single-producer ring (a
+    juce::AbstractFifo over a fixed array, so it never waits, locks or allocates).
+    The scope trace is decimated before it goes in: each frame only carries the
+    largest magnitude of every scopeDecimation samples, with its sign.
+
+    The feed is on while at least one editor is open. Each editor adds itself as a
+    reader when it opens and removes itself when it closes, so closing one of two open
+    editors leaves the other's meters running. With no readers the audio thread doesn't
+    measure anything and nothing new goes into the ring.
+*/
+class MeterFeed
+{
+public:
+    static constexpr int scopeDecimation = 8;
+    static constexpr int maxScopePoints = 16;    // Enough for a whole sub-block
+
+    struct Frame
+    {
+        float inputPeak = 0.0f, inputRms = 0.0f;
+        float outputPeak = 0.0f, outputRms = 0.0f;
+        float gainReductionDecibels = 0.0f;
+
+        // The mono input and output, decimated
+        int numScopePoints = 0;
+        std::array<float, maxScopePoints> scopeInput {}, scopeOutput {};
+    };
+
+    MeterFeed() = default;
+
+    /** Called by each editor as it opens and closes, in pairs. */
+    void addReader() noexcept       { numReaders.fetch_add (1, std::memory_order_relaxed); }
+    void removeReader() noexcept;
+    bool isActive() const noexcept  { return numReaders.load (std::memory_order_relaxed) > 0; }
+
+    //==============================================================================
+    // Audio thread
+
+    /** Measures a sub-block before it's processed. Only call while isActive(). */
+    void measureInput (const juce::AudioBuffer<float>& buffer) noexcept;
+
+    /** Measures the processed sub-block and pushes the finished frame. If the editor
+        hasn't kept up the frame is dropped, meters don't need every one. */
+    void measureOutput (const juce::AudioBuffer<float>& buffer, float gainReductionDecibels) noexcept;
+
+    //==============================================================================
+    // Message thread
+
+    /** Pops every frame that's ready, oldest first. Returns how many there were. */
+    int popFrames (const std::function<void (const Frame&)>& callback);
+
+private:
+    static void measure (const juce::AudioBuffer<float>& buffer, float& peak, float& rms,
+                         std::array<float, maxScopePoints>& scope, int& numScopePoints) noexcept;
+
+    std::atomic<int> numReaders { 0 };
+
+    static constexpr int ringSize = 512;
+    juce::AbstractFifo fifo { ringSize };
+    std::array<Frame, ringSize> ring;
+
+    // Audio thread only
+    Frame pending;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterFeed)
+};
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    MeterViews.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "MeterViews.h"
+
+namespace
+{
+    const juce::Colour meterBackground (0xff1a1a1a);
+    const juce::Colour accent (241, 85, 73);
+
+    // Readings fall back at this rate once the signal drops
+    constexpr float fallDecibelsPerSecond = 24.0f;
+}
+
+LevelMeter::LevelMeter (Style meterStyle)
+    : style (meterStyle),
+      minDecibels (meterStyle == Style::level ? -60.0f : 0.0f),
+      maxDecibels (meterStyle == Style::level ? 6.0f : 24.0f),
+      peak (minDecibels),
+      rms (minDecibels)
+{
+    setOpaque (true);
+}
+
+void LevelMeter::update (float peakDecibels, float rmsDecibels, double elapsedSeconds)
+{
+    const auto fall = fallDecibelsPerSecond * static_cast<float> (elapsedSeconds);
+
+    auto follow = [&] (float current, float target)
+    {
+        return juce::jlimit (minDecibels, maxDecibels, juce::jmax (target, current - fall));
+    };
+
+    peak = follow (peak, peakDecibels);
+    rms = follow (rms, rmsDecibels);
+
+    const auto peakY = toY (peak);
+    const auto rmsY = toY (rms);
+
+    if (peakY != paintedPeakY)
+        repaintBetween (paintedPeakY, peakY);
+
+    if (style == Style::level && rmsY != paintedRmsY)
+        repaintBetween (paintedRmsY, rmsY);
+
+    paintedPeakY = peakY;
+    paintedRmsY = rmsY;
+}
+
+int LevelMeter::toY (float decibels) const noexcept
+{
+    const auto proportion = (decibels - minDecibels) / (maxDecibels - minDecibels);
+    const auto height = static_cast<float> (getHeight());
+
+    // Levels grow up from the bottom, gain reduction hangs down from the top
+    return juce::roundToInt (style == Style::level ? height * (1.0f - proportion) : height * proportion);
+}
+
+void LevelMeter::repaintBetween (int y1, int y2)
+{
+    repaint (0, juce::jmin (y1, y2), getWidth(), std::abs (y1 - y2) + 1);
+}
+
+void LevelMeter::resized()
+{
+    paintedPeakY = toY (peak);
+    paintedRmsY = toY (rms);
+}
+
+void LevelMeter::paint (juce::Graphics& g)
+{
+    g.fillAll (meterBackground);
+
+    const auto width = getWidth();
+    const auto height = getHeight();
+    const auto peakY = toY (peak);
+
+    if (style == Style::gainReduction)
+    {
+        g.setColour (juce::Colours::orange);
+        g.fillRect (0, 0, width, peakY);
+        return;
+    }
+
+    const auto rmsY = toY (rms);
+
+    g.setColour (accent.withAlpha (0.45f));
+    g.fillRect (0, peakY, width, height - peakY);
+
+    g.setColour (accent);
+    g.fillRect (0, rmsY, width, height - rmsY);
+
+    // 0dBFS mark
+    g.setColour (juce::Colours::lightgrey.withAlpha (0.6f));
+    g.fillRect (0, toY (0.0f), width, 1);
+}
+
+//==============================================================================
+void ScopeView::pushFrame (const MeterFeed::Frame& frame) noexcept
+{
+    for (int i = 0; i < frame.numScopePoints; ++i)
+    {
+        inputPoints[(size_t) writeIndex] = frame.scopeInput[(size_t) i];
+        outputPoints[(size_t) writeIndex] = frame.scopeOutput[(size_t) i];
+        writeIndex = (writeIndex + 1) % numPoints;
+    }
+
+    hasNewPoints = hasNewPoints || frame.numScopePoints > 0;
+}
+
+void ScopeView::flush()
+{
+    if (! hasNewPoints)
+        return;
+
+    repaint (traceArea);
+    hasNewPoints = false;
+}
+
+void ScopeView::setCurve (Distortion::Mode newMode, float newDrive)
+{
+    if (newMode == mode && std::abs (newDrive - drive) < 1.0e-3f)
+        return;
+
+    mode = newMode;
+    drive = newDrive;
+
+    // Scaled so the curve always spans the square, the shape is what matters
+    const auto outputScale = 1.0f / juce::jmax (1.0e-3f, std::abs (Distortion::shapeSample (mode, drive)));
+    const auto area = curveArea.toFloat().reduced (2.0f);
+    constexpr int numSteps = 64;
+
+    curvePath.clear();
+
+    for (int step = 0; step <= numSteps; ++step)
+    {
+        const auto x = -1.0f + 2.0f * static_cast<float> (step) / numSteps;
+        const auto y = Distortion::shapeSample (mode, x * drive) * outputScale;
+        const juce::Point<float> point (area.getCentreX() + x * area.getWidth() * 0.5f,
+                                        area.getCentreY() - y * area.getHeight() * 0.5f);
+
+        if (step == 0)
+            curvePath.startNewSubPath (point);
+        else
+            curvePath.lineTo (point);
+    }
+
+    repaint (curveArea);
+}
+
+void ScopeView::resized()
+{
+    auto area = getLocalBounds();
+    curveArea = area.removeFromRight (area.getHeight());
+    area.removeFromRight (4);
+    traceArea = area;
+
+    // Rebuild the curve for the new size, once there is one
+    if (drive > 0.0f)
+    {
+        const auto currentDrive = drive;
+        drive = -1.0f;
+        setCurve (mode, currentDrive);
+    }
+}
+
+void ScopeView::paint (juce::Graphics& g)
+{
+    g.setColour (meterBackground);
+    g.fillRect (traceArea);
+    g.fillRect (curveArea);
+
+    g.setColour (juce::Colours::lightgrey.withAlpha (0.2f));
+    g.fillRect (traceArea.getX(), traceArea.getCentreY(), traceArea.getWidth(), 1);
+    g.fillRect (curveArea.getX(), curveArea.getCentreY(), curveArea.getWidth(), 1);
+    g.fillRect (curveArea.getCentreX(), curveArea.getY(), 1, curveArea.getHeight());
+
+    if (g.getClipBounds().intersects (traceArea))
+    {
+        const auto area = traceArea.toFloat().reduced (0.0f, 2.0f);
+        const auto step = area.getWidth() / static_cast<float> (numPoints - 1);
+
+        auto drawTrace = [&] (const std::array<float, numPoints>& points, juce::Colour colour)
+        {
+            juce::Path trace;
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const auto value = juce::jlimit (-1.0f, 1.0f, points[(size_t) ((writeIndex + i) % numPoints)]);
+                const juce::Point<float> point (area.getX() + static_cast<float> (i) * step,
+                                                area.getCentreY() - value * area.getHeight() * 0.5f);
+
+                if (i == 0)
+                    trace.startNewSubPath (point);
+                else
+                    trace.lineTo (point);
+            }
+
+            g.setColour (colour);
+            g.strokePath (trace, juce::PathStrokeType (1.0f));
+        };
+
+        drawTrace (inputPoints, juce::Colours::lightgrey.withAlpha (0.5f));
+        drawTrace (outputPoints, accent);
+    }
+
+    if (g.getClipBounds().intersects (curveArea))
+    {
+        g.setColour (accent);
+        g.strokePath (curvePath, juce::PathStrokeType (1.5f));
+    }
+}
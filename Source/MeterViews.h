@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    MeterViews.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MeterFeed.h"
+#include "Waveshaper.h"
+
+/**
+    Vertical bar meter: peak and RMS level, or gain reduction hanging down from the top.
+
+    The owner feeds it the latest values on its own refresh timer. Readings rise
+    instantly and fall back at a fixed rate, and only the strip of the bar that
+    actually moved since the last paint gets repainted.
+*/
+class LevelMeter : public juce::Component
+{
+public:
+    enum class Style
+    {
+        level,            // Peak and RMS, -60dB to +6dB
+        gainReduction     // 0dB to 24dB of reduction, drawn from the top down
+    };
+
+    explicit LevelMeter (Style meterStyle);
+
+    /** Peak and RMS in decibels, or the reduction (positive dB) for a gain reduction meter. */
+    void update (float peakDecibels, float rmsDecibels, double elapsedSeconds);
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    int toY (float decibels) const noexcept;
+    void repaintBetween (int y1, int y2);
+
+    const Style style;
+    const float minDecibels, maxDecibels;
+
+    float peak, rms;
+    int paintedPeakY = 0, paintedRmsY = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
+
+//==============================================================================
+/**
+    Oscilloscope of the last few thousand samples of input and output, next to the
+    shaper's transfer curve at the current drive.
+
+    Each half only repaints when it has something new: the trace when frames arrive,
+    the curve when the mode or drive changes.
+*/
+class ScopeView : public juce::Component
+{
+public:
+    ScopeView() = default;
+
+    void pushFrame (const MeterFeed::Frame& frame) noexcept;
+
+    /** Call after pushing a batch of frames, repaints the trace if anything arrived. */
+    void flush();
+
+    void setCurve (Distortion::Mode newMode, float newDrive);
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    static constexpr int numPoints = 512;
+
+    juce::Rectangle<int> traceArea, curveArea;
+
+    // Circular history of decimated points, writeIndex is the oldest
+    std::array<float, numPoints> inputPoints {}, outputPoints {};
+    int writeIndex = 0;
+    bool hasNewPoints = false;
+
+    Distortion::Mode mode = Distortion::Mode::hardClip;
+    float drive = -1.0f;
+    juce::Path curvePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScopeView)
+};
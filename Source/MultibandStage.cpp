@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    MultibandStage.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "MultibandStage.h"
+
+float MultibandStage::Band::getLatencyInSamples() const noexcept
+{
+    return oversampling.getExactLatencyInSamples()
+         + waveshaper.getLatencyInSamples() / static_cast<float> (oversampling.getFactor());
+}
+
+//==============================================================================
+void MultibandStage::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    preparedChannels = spec.numChannels;
+
+    bandBuffer.setSize (static_cast<int> (preparedChannels) * maxBands, static_cast<int> (spec.maximumBlockSize));
+    dryBuffer.setSize (static_cast<int> (preparedChannels), static_cast<int> (spec.maximumBlockSize));
+    driveRamp.allocate (static_cast<size_t> (spec.maximumBlockSize) * OversamplingStage::maxFactor, true);
+
+    // Band shapers are prepared at the highest rate, like the broadband one
+    auto oversampledSpec = spec;
+    oversampledSpec.sampleRate = spec.sampleRate * OversamplingStage::maxFactor;
+    oversampledSpec.maximumBlockSize = spec.maximumBlockSize * OversamplingStage::maxFactor;
+
+    for (auto& band : bands)
+    {
+        band.oversampling.prepare (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+        band.oversampling.select (band.settings.oversamplingIndex, quality);
+        band.waveshaper.prepare (oversampledSpec);
+
+        for (auto& state : band.waveshaperStates)
+            band.waveshaper.saveState (state);
+
+        band.waveshaper.setRateScale (static_cast<float> (OversamplingStage::maxFactor) / static_cast<float> (band.oversampling.getFactor()));
+        band.mixer.prepare (spec);
+        band.mixer.setMixingRule (juce::dsp::DryWetMixingRule::linear);
+        band.alignment.prepare (spec);
+        band.dryDelay.prepare (spec);
+        band.drive.reset (sampleRate * band.oversampling.getFactor(), 0.05);
+    }
+
+    for (auto& cutoff : crossoverCutoffs)
+        cutoff.reset (sampleRate, 0.05);
+
+    for (auto& splitter : splitters)
+        splitter.prepare (spec);
+
+    for (auto& row : compensation)
+    {
+        for (auto& allpass : row)
+        {
+            allpass.prepare (spec);
+            allpass.setType (juce::dsp::LinkwitzRileyFilterType::allpass);
+        }
+    }
+
+    reset();
+}
+
+void MultibandStage::reset()
+{
+    for (auto& band : bands)
+    {
+        resetBand (band);
+        band.alignment.reset();
+        band.dryDelay.reset();
+
+        // Nothing to crossfade from, the next block just takes up its bypass state
+        band.wasActive = ! band.settings.bypassed;
+    }
+
+    // The crossovers jump to their targets, and every filter is forced through the next update
+    for (size_t k = 0; k < crossoverCutoffs.size(); ++k)
+        crossoverCutoffs[k].setCurrentAndTargetValue (juce::jlimit (20.0f, static_cast<float> (sampleRate * 0.45), crossoverTargets[k]));
+
+    crossoverFrequencies.fill (0.0f);
+    updateCrossovers (0);
+
+    for (auto& splitter : splitters)
+        splitter.reset();
+
+    for (auto& row : compensation)
+        for (auto& allpass : row)
+            allpass.reset();
+}
+
+void MultibandStage::resetBand (Band& band)
+{
+    band.oversampling.reset();
+    band.waveshaper.reset();
+    band.mixer.reset();
+    band.drive.setCurrentAndTargetValue (band.drive.getTargetValue());
+}
+
+//==============================================================================
+void MultibandStage::setNumBands (int newNumBands) noexcept
+{
+    numBands = juce::jlimit (2, maxBands, newNumBands);
+}
+
+void MultibandStage::setCrossover (int index, float frequency) noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, maxBands - 1));
+    crossoverTargets[(size_t) index] = frequency;
+}
+
+void MultibandStage::setBand (int index, const BandSettings& settings) noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, maxBands));
+    auto& band = bands[(size_t) index];
+    band.settings = settings;
+
+    if (band.oversampling.select (settings.oversamplingIndex, quality))
+    {
+        band.waveshaper.setRateScale (static_cast<float> (OversamplingStage::maxFactor) / static_cast<float> (band.oversampling.getFactor()));
+        band.drive.reset (sampleRate * band.oversampling.getFactor(), 0.05);
+    }
+
+    band.drive.setTargetValue (settings.drive);
+    band.waveshaper.setMode (settings.mode);
+    band.mixer.setWetMixProportion (settings.mix);
+}
+
+void MultibandStage::setUseFastApproximations (bool shouldUseFast) noexcept
+{
+    for (auto& band : bands)
+        band.waveshaper.setUseFastApproximations (shouldUseFast);
+}
+
+void MultibandStage::setEngine (Distortion::Engine engine) noexcept
+{
+    for (auto& band : bands)
+        band.waveshaper.setEngine (engine);
+}
+
+void MultibandStage::setAntialiasing (Distortion::Antialiasing antialiasing) noexcept
+{
+    for (auto& band : bands)
+        band.waveshaper.setAntialiasing (antialiasing);
+}
+
+void MultibandStage::setDynamics (float thresholdDecibels, float ratio, float attackMs, float releaseMs) noexcept
+{
+    for (auto& band : bands)
+        band.waveshaper.setDynamics (thresholdDecibels, ratio, attackMs, releaseMs);
+}
+
+void MultibandStage::setChannelGroups (const std::vector<int>& groups) noexcept
+{
+    for (auto& band : bands)
+        band.waveshaper.setChannelGroups (groups);
+}
+
+float MultibandStage::getGainReductionDecibels() const noexcept
+{
+    auto reduction = 0.0f;
+
+    for (int i = 0; i < numBands; ++i)
+        if (! bands[(size_t) i].settings.bypassed)
+            reduction = juce::jmax (reduction, bands[(size_t) i].waveshaper.getGainReductionDecibels());
+
+    return reduction;
+}
+
+float MultibandStage::getLatencyInSamples() const noexcept
+{
+    // Bypassed bands count too, so bypassing one doesn't move the reported latency
+    float latency = 0.0f;
+
+    for (int i = 0; i < numBands; ++i)
+        latency = juce::jmax (latency, bands[(size_t) i].getLatencyInSamples());
+
+    return latency;
+}
+
+void MultibandStage::updateCrossovers (int numSamples) noexcept
+{
+    const auto maxFrequency = static_cast<float> (sampleRate * 0.45);
+    auto previous = 20.0f;
+
+    for (size_t k = 0; k < crossoverTargets.size(); ++k)
+    {
+        // Each crossover ramps on its own, so the order is kept on the ramped values
+        auto& cutoff = crossoverCutoffs[k];
+        cutoff.setTargetValue (juce::jlimit (20.0f, maxFrequency, crossoverTargets[k]));
+
+        const auto frequency = juce::jlimit (previous, maxFrequency, cutoff.skip (numSamples));
+        previous = frequency;
+
+        // setCutoffFrequency recalculates a tan() every call, so only make it when something moved
+        if (frequency == crossoverFrequencies[k])
+            continue;
+
+        crossoverFrequencies[k] = frequency;
+        splitters[k].setCutoffFrequency (frequency);
+
+        for (size_t band = 0; band < k; ++band)
+            compensation[band][k].setCutoffFrequency (frequency);
+    }
+}
+
+juce::dsp::AudioBlock<float> MultibandStage::getBandBlock (int index, size_t numChannels, size_t numSamples) noexcept
+{
+    return juce::dsp::AudioBlock<float> (bandBuffer).getSubsetChannelBlock (static_cast<size_t> (index) * preparedChannels, numChannels)
+                                                    .getSubBlock (0, numSamples);
+}
+
+//==============================================================================
+void MultibandStage::split (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+
+    // The crossovers follow their ramps every few samples, and stay put while they're still
+    for (size_t start = 0; start < numSamples; start += updateInterval)
+    {
+        const auto length = juce::jmin (static_cast<size_t> (updateInterval), numSamples - start);
+        updateCrossovers (static_cast<int> (length));
+        splitRange (block, start, length);
+    }
+
+    for (auto& splitter : splitters)
+        splitter.snapToZero();
+}
+
+void MultibandStage::splitRange (juce::dsp::AudioBlock<float>& block, size_t start, size_t length) noexcept
+{
+    const auto numChannels = block.getNumChannels();
+    const auto lastBand = static_cast<size_t> (numBands - 1);
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* input = block.getChannelPointer (channel) + start;
+        std::array<float*, maxBands> outputs {};
+
+        for (size_t band = 0; band <= lastBand; ++band)
+            outputs[band] = bandBuffer.getWritePointer (static_cast<int> (band * preparedChannels + channel)) + start;
+
+        const auto channelIndex = static_cast<int> (channel);
+
+        // One pass writes every band of each sample, rather than one pass over the block per band
+        for (size_t i = 0; i < length; ++i)
+        {
+            auto remaining = input[i];
+
+            for (size_t k = 0; k < lastBand; ++k)
+            {
+                float low, high;
+                splitters[k].processSample (channelIndex, remaining, low, high);
+
+                // Match the phase shift the bands above this one pick up at the later crossovers
+                for (size_t j = k + 1; j < lastBand; ++j)
+                    low = compensation[k][j].processSample (channelIndex, low);
+
+                outputs[k][i] = low;
+                remaining = high;
+            }
+
+            outputs[lastBand][i] = remaining;
+        }
+    }
+}
+
+void MultibandStage::recombine (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    const auto lastBand = static_cast<size_t> (numBands - 1);
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* output = block.getChannelPointer (channel);
+        std::array<const float*, maxBands> inputs {};
+
+        for (size_t band = 0; band <= lastBand; ++band)
+            inputs[band] = bandBuffer.getReadPointer (static_cast<int> (band * preparedChannels + channel));
+
+        // Like the split, one pass reads every band of each sample
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto sum = inputs[0][i];
+
+            for (size_t band = 1; band <= lastBand; ++band)
+                sum += inputs[band][i];
+
+            output[i] = sum;
+        }
+    }
+}
+
+void MultibandStage::processBand (Band& band, juce::dsp::AudioBlock<float>& bandBlock, juce::dsp::AudioBlock<float>& dryBlock) noexcept
+{
+    // The dry side already carries the band's latency, so the mixer doesn't delay it again
+    band.mixer.pushDrySamples (dryBlock);
+
+    const auto activeFactor = band.oversampling.getFactor();
+    const auto driveIsSmoothing = band.drive.isSmoothing();
+
+    // Timed for the active factor, so it's worked out once even when a switch runs the shaper twice
+    if (driveIsSmoothing)
+        for (int i = 0; i < static_cast<int> (bandBlock.getNumSamples()) * activeFactor; ++i)
+            driveRamp[i] = band.drive.getNextValue();
+
+    band.oversampling.process (bandBlock, [&] (juce::dsp::AudioBlock<float>& oversampledBlock, int factor, OversamplingStage::Run run)
+    {
+        band.waveshaper.setRateScale (static_cast<float> (OversamplingStage::maxFactor) / static_cast<float> (factor));
+
+        if (driveIsSmoothing && run == OversamplingStage::Run::active)
+            band.waveshaper.setDriveRamp (driveRamp.get());
+        else
+            band.waveshaper.setDrive (band.drive.getTargetValue());
+
+        band.waveshaper.process (juce::dsp::ProcessContextReplacing<float> (oversampledBlock));
+
+        if (makeupGainEngaged)
+            oversampledBlock.multiplyBy (OutputStage::getMakeupGain (band.drive.getTargetValue()));
+    },
+    [&band] (OversamplingStage::StateSlot slot)    { band.waveshaper.saveState (band.waveshaperStates[(size_t) slot]); },
+    [&band] (OversamplingStage::StateSlot slot)    { band.waveshaper.restoreState (band.waveshaperStates[(size_t) slot]); });
+
+    band.mixer.mixWetSamples (bandBlock);
+}
+
+void MultibandStage::processOrBypass (Band& band, juce::dsp::AudioBlock<float>& bandBlock) noexcept
+{
+    // The band's dry signal, delayed to match what the band's processing would add. It's
+    // the mix's dry side, and it's fed every block so it's ready to crossfade to whenever
+    // the band is bypassed.
+    auto dryBlock = juce::dsp::AudioBlock<float> (dryBuffer).getSubsetChannelBlock (0, bandBlock.getNumChannels())
+                                                            .getSubBlock (0, bandBlock.getNumSamples());
+    dryBlock.copyFrom (bandBlock);
+
+    band.dryDelay.setDelay (band.getLatencyInSamples());
+    band.dryDelay.process (dryBlock);
+
+    const auto isActive = ! band.settings.bypassed;
+    const auto isSwitching = isActive != band.wasActive;
+
+    // A band coming out of bypass starts from clean state rather than whatever it held,
+    // which the crossfade below hides
+    if (isActive && ! band.wasActive)
+        resetBand (band);
+
+    band.wasActive = isActive;
+
+    // Going into bypass, the band runs one last block to fade out of
+    if (isActive || isSwitching)
+        processBand (band, bandBlock, dryBlock);
+
+    if (! isSwitching)
+    {
+        if (! isActive)
+            bandBlock.copyFrom (dryBlock);
+
+        return;
+    }
+
+    const auto numSamples = bandBlock.getNumSamples();
+    const auto step = 1.0f / static_cast<float> (numSamples);
+
+    for (size_t channel = 0; channel < bandBlock.getNumChannels(); ++channel)
+    {
+        auto* processed = bandBlock.getChannelPointer (channel);
+        const auto* bypassed = dryBlock.getChannelPointer (channel);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto progress = static_cast<float> (i + 1) * step;
+            const auto gain = isActive ? progress : 1.0f - progress;
+            processed[i] = bypassed[i] + gain * (processed[i] - bypassed[i]);
+        }
+    }
+}
+
+void MultibandStage::process (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    jassert (numChannels <= preparedChannels && numSamples <= static_cast<size_t> (bandBuffer.getNumSamples()));
+
+    split (block);
+
+    const auto latency = getLatencyInSamples();
+
+    for (int index = 0; index < numBands; ++index)
+    {
+        auto& band = bands[(size_t) index];
+        auto bandBlock = getBandBlock (index, numChannels, numSamples);
+
+        processOrBypass (band, bandBlock);
+
+        // Line every band up with the slowest one. Bypassed or not, a band's signal now
+        // carries its own latency, so only the oversampling and engine settings move this.
+        band.alignment.setDelay (latency - band.getLatencyInSamples());
+        band.alignment.process (bandBlock);
+    }
+
+    recombine (block);
+}
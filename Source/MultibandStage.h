@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    MultibandStage.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Waveshaper.h"
+#include "OversamplingStage.h"
+#include "OutputStage.h"
+#include "AlignmentDelay.h"
+
+/**
+    Splits the signal into 2-4 bands with Linkwitz-Riley crossovers and distorts each
+    band with its own drive, mode, mix and oversampling factor.
+
+    Works at the host rate, in and out. The split is a single pass over the input,
+    writing every band of a sample at once into per-band buffers, and the recombine is
+    a single pass too, reading every band of a sample at once. The bands themselves
+    run one after the other over their own buffers, each at its own oversampling
+    factor, so a 1x low band costs almost nothing and a bypassed band skips its
+    oversampler and shaper entirely. Crossovers are smoothed, and the filters follow
+    the ramp every updateInterval samples.
+
+    Bands come out of their oversamplers with different latencies, so each one is
+    delayed up to the slowest band's latency before they're summed. Each band's dry
+    signal is delayed by the band's own latency, which gives both its mix's dry side
+    and what it's replaced by when bypassed, so bypass never moves the alignment, and
+    going in or out of bypass crossfades across one block. All of these delays are
+    AlignmentDelays, so a band changing factor or engine fades to the new delays.
+*/
+class MultibandStage
+{
+public:
+    static constexpr int maxBands = 4;
+
+    struct BandSettings
+    {
+        float drive = 1.0f;
+        Distortion::Mode mode = Distortion::Mode::hardClip;
+        float mix = 1.0f;
+        bool bypassed = false;
+        int oversamplingIndex = 0;
+    };
+
+    MultibandStage() = default;
+
+    /** Builds every band's oversamplers, call from prepareToPlay only. */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void setNumBands (int newNumBands) noexcept;
+    int getNumBands() const noexcept    { return numBands; }
+
+    /** Crossovers are kept in ascending order, a crossover below the previous one sits on it. */
+    void setCrossover (int index, float frequency) noexcept;
+
+    void setBand (int index, const BandSettings& settings) noexcept;
+
+    void setOversamplingQuality (OversamplingStage::FilterQuality newQuality) noexcept    { quality = newQuality; }
+    void setUseFastApproximations (bool shouldUseFast) noexcept;
+    void setEngine (Distortion::Engine engine) noexcept;
+    void setAntialiasing (Distortion::Antialiasing antialiasing) noexcept;
+    void setDynamics (float thresholdDecibels, float ratio, float attackMs, float releaseMs) noexcept;
+    void setChannelGroups (const std::vector<int>& groups) noexcept;
+    void setMakeupGainEngaged (bool shouldApplyMakeup) noexcept    { makeupGainEngaged = shouldApplyMakeup; }
+
+    /** The deepest tubeIsh gain reduction of any active band in the last block, in decibels. */
+    float getGainReductionDecibels() const noexcept;
+
+    /** Latency of the slowest band the current band count uses, in samples at the host rate. */
+    float getLatencyInSamples() const noexcept;
+
+    void process (juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    struct Band
+    {
+        OversamplingStage oversampling;
+        Waveshaper waveshaper;
+        std::array<Waveshaper::State, OversamplingStage::numStateSlots> waveshaperStates;
+        juce::dsp::DryWetMixer<float> mixer;
+        AlignmentDelay alignment, dryDelay;
+        juce::SmoothedValue<float> drive;
+
+        BandSettings settings;
+        bool wasActive = false;
+
+        float getLatencyInSamples() const noexcept;
+    };
+
+    void split (juce::dsp::AudioBlock<float>& block) noexcept;
+    void splitRange (juce::dsp::AudioBlock<float>& block, size_t start, size_t length) noexcept;
+    void recombine (juce::dsp::AudioBlock<float>& block) noexcept;
+    void processBand (Band& band, juce::dsp::AudioBlock<float>& bandBlock, juce::dsp::AudioBlock<float>& dryBlock) noexcept;
+    void processOrBypass (Band& band, juce::dsp::AudioBlock<float>& bandBlock) noexcept;
+    void resetBand (Band& band);
+    void updateCrossovers (int numSamples) noexcept;
+
+    juce::dsp::AudioBlock<float> getBandBlock (int index, size_t numChannels, size_t numSamples) noexcept;
+
+    std::array<Band, maxBands> bands;
+
+    // splitters[k] separates band k from everything above it. compensation[k][j] is the
+    // allpass that gives band k the same phase shift crossover j gives the bands above it.
+    std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1> splitters;
+    std::array<std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1>, maxBands - 1> compensation;
+    std::array<float, maxBands - 1> crossoverTargets { { 200.0f, 1000.0f, 5000.0f } };
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>, maxBands - 1> crossoverCutoffs;
+    std::array<float, maxBands - 1> crossoverFrequencies {};
+    static constexpr int updateInterval = 32;
+
+    // All bands' channels in one allocation: band b, channel c lives in channel b * numChannels + c
+    juce::AudioBuffer<float> bandBuffer;
+
+    // One band's delayed dry signal, while it's being worked out
+    juce::AudioBuffer<float> dryBuffer;
+    juce::HeapBlock<float> driveRamp;
+
+    int numBands = 2;
+    double sampleRate = 44100.0;
+    size_t preparedChannels = 0;
+    OversamplingStage::FilterQuality quality = OversamplingStage::FilterQuality::iir;
+    bool makeupGainEngaged = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultibandStage)
+};
@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    OutputStage.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "OutputStage.h"
+
+void OutputStage::process (juce::dsp::AudioBlock<float>& block) const noexcept
+{
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer (channel);
+
+        if (gainRamp != nullptr)
+            juce::FloatVectorOperations::multiply (data, gainRamp, numSamples);
+        else
+            juce::FloatVectorOperations::multiply (data, gain, numSamples);
+    }
+}
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    OutputStage.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Output volume and auto makeup gain folded into a single gain, applied after the
+    dry/wet mix at the host rate.
+
+    The gain is worked out once per block, or once per sample only while one of the
+    underlying parameters is ramping.
+*/
+class OutputStage
+{
+public:
+    OutputStage() = default;
+
+    /** Block-constant linear gain. */
+    void setGain (float newGain) noexcept                  { gain = newGain; gainRamp = nullptr; }
+
+    /** Per-sample linear gain for the next process() call. The ramp must cover the whole block. */
+    void setGainRamp (const float* newGainRamp) noexcept   { gainRamp = newGainRamp; }
+
+    void process (juce::dsp::AudioBlock<float>& block) const noexcept;
+
+    /** Makeup gain that compensates the level increase from drive. */
+    static float getMakeupGain (float drive) noexcept      { return 1.0f / std::pow (drive, 0.65f); }
+
+private:
+    float gain = 1.0f;
+    const float* gainRamp = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutputStage)
+};
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    OversamplingStage.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "OversamplingStage.h"
+
+void OversamplingStage::prepare (int numChannels, int maximumBlockSizeToUse)
+{
+    maximumBlockSize = maximumBlockSizeToUse;
+
+    using Filter = juce::dsp::Oversampling<float>::FilterType;
+
+    for (int factorIndex = 0; factorIndex < numFactors; ++factorIndex)
+    {
+        for (auto quality : { FilterQuality::iir, FilterQuality::linearPhase })
+        {
+            const auto isLinearPhase = quality == FilterQuality::linearPhase;
+
+            auto& oversampler = oversamplers[(size_t) indexFor (factorIndex, quality)];
+            oversampler = std::make_unique<juce::dsp::Oversampling<float>> (static_cast<size_t> (numChannels),
+                                                                            static_cast<size_t> (factorIndex),
+                                                                            isLinearPhase ? Filter::filterHalfBandFIREquiripple
+                                                                                          : Filter::filterHalfBandPolyphaseIIR,
+                                                                            isLinearPhase);
+            oversampler->initProcessing (static_cast<size_t> (maximumBlockSize));
+        }
+    }
+
+    // Enough input to run through the longest filters twice over, in whole blocks
+    int longestLatency = 0;
+
+    for (auto& oversampler : oversamplers)
+        longestLatency = juce::jmax (longestLatency, juce::roundToInt (oversampler->getLatencyInSamples()));
+
+    const auto numHistoryBlocks = juce::jmax (1, (2 * longestLatency + maximumBlockSize - 1) / maximumBlockSize);
+    history.setSize (numChannels, numHistoryBlocks * maximumBlockSize);
+    scratch.setSize (numChannels, maximumBlockSize);
+
+    reset();
+}
+
+void OversamplingStage::reset()
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+
+    history.clear();
+    historyPosition = 0;
+    hasHistory = false;
+    outgoingIndex = -1;
+    fadePosition = 0;
+    pendingStateChange = StateChange::none;
+    needsPreroll = false;
+}
+
+bool OversamplingStage::select (int factorIndex, FilterQuality quality) noexcept
+{
+    factorIndex = juce::jlimit (0, numFactors - 1, factorIndex);
+
+    if (factorIndex == activeFactorIndex && quality == activeQuality)
+        return false;
+
+    const auto previousIndex = activeIndex;
+    activeFactorIndex = factorIndex;
+    activeQuality = quality;
+    activeIndex = indexFor (factorIndex, quality);
+
+    // Before any audio there's nothing to carry across, just start clean
+    if (! hasHistory)
+    {
+        getActive().reset();
+        outgoingIndex = -1;
+        pendingStateChange = StateChange::none;
+        needsPreroll = false;
+        return true;
+    }
+
+    // Switching again mid-fade keeps fading from whatever was playing before, and
+    // switching straight back to it leaves it untouched
+    if (outgoingIndex < 0)
+    {
+        outgoingIndex = previousIndex;
+        pendingStateChange = StateChange::branchOutgoing;
+    }
+
+    fadePosition = 0;
+
+    if (activeIndex == outgoingIndex)
+    {
+        // If the outgoing state was never branched off, the current state is still its own
+        pendingStateChange = pendingStateChange == StateChange::branchOutgoing ? StateChange::none
+                                                                               : StateChange::resumeOutgoing;
+        outgoingIndex = -1;
+        needsPreroll = false;
+        return true;
+    }
+
+    needsPreroll = true;
+    return true;
+}
+
+//==============================================================================
+void OversamplingStage::pushHistory (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto length = history.getNumSamples();
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+    const auto numChannels = juce::jmin (static_cast<int> (block.getNumChannels()), history.getNumChannels());
+    const auto numToEnd = juce::jmin (numSamples, length - historyPosition);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* destination = history.getWritePointer (channel);
+        const auto* source = block.getChannelPointer (static_cast<size_t> (channel));
+
+        juce::FloatVectorOperations::copy (destination + historyPosition, source, numToEnd);
+        juce::FloatVectorOperations::copy (destination, source + numToEnd, numSamples - numToEnd);
+    }
+
+    historyPosition = (historyPosition + numSamples) % length;
+    hasHistory = true;
+}
+
+juce::dsp::AudioBlock<float> OversamplingStage::getHistoryBlock (int start) noexcept
+{
+    // One block of the history, counting from the oldest sample, copied out into the scratch buffer
+    const auto length = history.getNumSamples();
+    const auto position = (historyPosition + start) % length;
+    const auto numToEnd = juce::jmin (maximumBlockSize, length - position);
+
+    for (int channel = 0; channel < scratch.getNumChannels(); ++channel)
+    {
+        auto* destination = scratch.getWritePointer (channel);
+        const auto* source = history.getReadPointer (channel);
+
+        juce::FloatVectorOperations::copy (destination, source + position, numToEnd);
+        juce::FloatVectorOperations::copy (destination + numToEnd, source, maximumBlockSize - numToEnd);
+    }
+
+    return juce::dsp::AudioBlock<float> (scratch);
+}
+
+juce::dsp::AudioBlock<float> OversamplingStage::getFadeBlock (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    return juce::dsp::AudioBlock<float> (scratch).getSubsetChannelBlock (0, block.getNumChannels())
+                                                 .getSubBlock (0, block.getNumSamples());
+}
+
+void OversamplingStage::crossfadeFromOutgoing (juce::dsp::AudioBlock<float>& block) noexcept
+{
+    // A linear fade over one full block's worth of samples, however the blocks fall
+    const auto outgoingBlock = getFadeBlock (block);
+    const auto numSamples = static_cast<int> (block.getNumSamples());
+    const auto fadeLength = static_cast<float> (maximumBlockSize);
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* output = block.getChannelPointer (channel);
+        const auto* outgoing = outgoingBlock.getChannelPointer (channel);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto gain = juce::jmin (1.0f, static_cast<float> (fadePosition + i + 1) / fadeLength);
+            output[i] = outgoing[i] + gain * (output[i] - outgoing[i]);
+        }
+    }
+
+    fadePosition += numSamples;
+
+    if (fadePosition >= maximumBlockSize)
+        outgoingIndex = -1;
+}
+
+int OversamplingStage::getLatencyInSamples() const noexcept
+{
+    return juce::roundToInt (getExactLatencyInSamples());
+}
+
+float OversamplingStage::getExactLatencyInSamples() const noexcept
+{
+    if (auto* oversampler = oversamplers[(size_t) activeIndex].get())
+        return static_cast<float> (oversampler->getLatencyInSamples());
+
+    return 0.0f;
+}
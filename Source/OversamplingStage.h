@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    OversamplingStage.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Owns one oversampler for every factor/filter combination the OVERSAMPLING and
+    OVERSAMPLINGFILTER parameters can select.
+
+    All of them are built and initialised in prepare(), so switching setting from the
+    audio thread is just a pointer change with no allocation or filter design.
+
+    A switch is seamless. The incoming oversampler is pre-rolled with the most recent
+    input, run through the caller's processing as well, so its filters hold the shaped
+    signal rather than silence. For the next block's worth of samples process() runs
+    both oversamplers and crossfades from the outgoing one to the incoming one, which
+    covers the jump in latency between them.
+
+    Both runs of a crossfade go through the same processing objects, so process() has
+    the caller save and restore their state around the extra runs. The outgoing run
+    carries on from its own copy, taken when the switch happened, and the incoming and
+    pre-roll runs never see what the outgoing one did to it.
+*/
+class OversamplingStage
+{
+public:
+    // Index into the OVERSAMPLING choice parameter: 1x, 2x, 4x, 8x, 16x
+    static constexpr int numFactors = 5;
+    static constexpr int maxFactor = 1 << (numFactors - 1);
+
+    enum class FilterQuality
+    {
+        iir = 0,         // Polyphase IIR half-band, low latency
+        linearPhase      // Equiripple FIR half-band, linear phase
+    };
+
+    OversamplingStage() = default;
+
+    /** Builds every oversampler. Call from prepareToPlay only, this allocates. */
+    void prepare (int numChannels, int maximumBlockSizeToUse);
+    void reset();
+
+    /** Selects the active oversampler. Returns true if the setting actually changed. */
+    bool select (int factorIndex, FilterQuality quality) noexcept;
+
+    /** Which run a processOversampled call is for. */
+    enum class Run
+    {
+        active,     // The active oversampler, whose output is the one kept
+        outgoing,   // The oversampler being faded out after a switch
+        preroll     // Recent input, filling a newly selected oversampler's filters
+    };
+
+    /** Where process() has the caller keep the state of whatever processOversampled runs. */
+    enum class StateSlot
+    {
+        outgoing = 0,   // The outgoing run's state, for as long as the crossfade lasts
+        scratch         // The active state, held while another run borrows the objects
+    };
+
+    static constexpr int numStateSlots = 2;
+
+    /** Upsamples block, hands the oversampled block, its factor and the kind of run to
+        processOversampled, then downsamples the result back into block.
+
+        Right after a switch this also calls processOversampled for the pre-roll and,
+        while the switch is being crossfaded, for the outgoing oversampler at its own
+        factor. Anything the callback does that depends on the rate has to follow the
+        factor it's given. Around those runs it calls saveState (slot) and
+        restoreState (slot), which have to copy the callback's processing state into
+        and out of the slot, e.g. with FilterStage::saveState and restoreState. */
+    template <typename ProcessFunction, typename SaveFunction, typename RestoreFunction>
+    void process (juce::dsp::AudioBlock<float>& block, ProcessFunction&& processOversampled,
+                  SaveFunction&& saveState, RestoreFunction&& restoreState)
+    {
+        // Back to the setting that was fading out, so its state is the one to carry on with
+        if (pendingStateChange == StateChange::resumeOutgoing)
+            restoreState (StateSlot::outgoing);
+
+        // A new switch: the outgoing run branches off from here
+        if (pendingStateChange == StateChange::branchOutgoing)
+            saveState (StateSlot::outgoing);
+
+        pendingStateChange = StateChange::none;
+
+        if (needsPreroll)
+        {
+            saveState (StateSlot::scratch);
+            preroll (getActive(), processOversampled);
+            restoreState (StateSlot::scratch);
+            needsPreroll = false;
+        }
+
+        pushHistory (block);
+
+        if (outgoingIndex >= 0)
+        {
+            auto outgoingBlock = getFadeBlock (block);
+            outgoingBlock.copyFrom (block);
+
+            saveState (StateSlot::scratch);
+            restoreState (StateSlot::outgoing);
+
+            auto& outgoing = *oversamplers[(size_t) outgoingIndex];
+            auto oversampledOutgoing = outgoing.processSamplesUp (outgoingBlock);
+            processOversampled (oversampledOutgoing, getFactorForIndex (outgoingIndex), Run::outgoing);
+            outgoing.processSamplesDown (outgoingBlock);
+
+            saveState (StateSlot::outgoing);
+            restoreState (StateSlot::scratch);
+        }
+
+        auto oversampled = getActive().processSamplesUp (block);
+        processOversampled (oversampled, getFactor(), Run::active);
+        getActive().processSamplesDown (block);
+
+        if (outgoingIndex >= 0)
+            crossfadeFromOutgoing (block);
+    }
+
+    int getFactor() const noexcept                           { return 1 << activeFactorIndex; }
+    int getFactorIndex() const noexcept                      { return activeFactorIndex; }
+    FilterQuality getQuality() const noexcept                { return activeQuality; }
+
+    /** Latency of the active oversampler, in samples at the base rate. */
+    int getLatencyInSamples() const noexcept;
+
+    /** The unrounded latency, for delaying a dry path to line up exactly. */
+    float getExactLatencyInSamples() const noexcept;
+
+    static juce::StringArray getFactorNames()                { return { "1x", "2x", "4x", "8x", "16x" }; }
+    static juce::StringArray getQualityNames()               { return { "IIR (Low Latency)", "FIR (Linear Phase)" }; }
+
+private:
+    juce::dsp::Oversampling<float>& getActive() noexcept    { return *oversamplers[(size_t) activeIndex]; }
+
+    static int indexFor (int factorIndex, FilterQuality quality) noexcept
+    {
+        return factorIndex * 2 + static_cast<int> (quality);
+    }
+
+    static int getFactorForIndex (int index) noexcept    { return 1 << (index / 2); }
+
+    void pushHistory (const juce::dsp::AudioBlock<float>& block) noexcept;
+    juce::dsp::AudioBlock<float> getHistoryBlock (int start) noexcept;
+    juce::dsp::AudioBlock<float> getFadeBlock (const juce::dsp::AudioBlock<float>& block) noexcept;
+    void crossfadeFromOutgoing (juce::dsp::AudioBlock<float>& block) noexcept;
+
+    template <typename ProcessFunction>
+    void preroll (juce::dsp::Oversampling<float>& oversampler, ProcessFunction& processOversampled)
+    {
+        // Runs the history through oldest first, so the filters end up holding the recent
+        // signal instead of the silence a reset leaves, and the output doesn't drop out.
+        // The caller's processing runs too, or the downsampler would hold the clean
+        // signal and ring its way over to the shaped one during the crossfade.
+        oversampler.reset();
+
+        for (int start = 0; start < history.getNumSamples(); start += maximumBlockSize)
+        {
+            auto block = getHistoryBlock (start);
+            auto oversampled = oversampler.processSamplesUp (block);
+            processOversampled (oversampled, getFactor(), Run::preroll);
+            oversampler.processSamplesDown (block);
+        }
+    }
+
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numFactors * 2> oversamplers;
+
+    int activeFactorIndex = 2;
+    FilterQuality activeQuality = FilterQuality::iir;
+    int activeIndex = indexFor (2, FilterQuality::iir);
+
+    // The oversampler being faded out after a switch, -1 if none. The fade lasts one
+    // full block's worth of samples, fadePosition counts through it.
+    int outgoingIndex = -1;
+    int fadePosition = 0;
+
+    // Set by select(), carried out at the start of the next process() where the
+    // callback is to hand
+    enum class StateChange { none, branchOutgoing, resumeOutgoing };
+    StateChange pendingStateChange = StateChange::none;
+    bool needsPreroll = false;
+
+    // The most recent input, oldest first from historyPosition, for pre-rolling an
+    // incoming oversampler. hasHistory is false until a block has gone through since
+    // the last reset, a switch before then has nothing to fade from.
+    juce::AudioBuffer<float> history, scratch;
+    int historyPosition = 0, maximumBlockSize = 0;
+    bool hasHistory = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingStage)
+};
@@ -1,114 +1,272 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-DeetzStortionAPVTSAudioProcessorEditor::DeetzStortionAPVTSAudioProcessorEditor (DeetzStortionAPVTSAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
-{
-    //background properties
-    background_image = juce::Drawable::createFromImageData(BinaryData::pluginBackground_svg, BinaryData::pluginBackground_svgSize);
-    addAndMakeVisible(*background_image);
-    
-    //Highpass
-    mhighpassSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
-    mhighpassSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
-    mhighpassSlider.setSkewFactor(15.0f,true);
-    mhighpassSlider.setLookAndFeel(&sliderLookAndFeel);
-    mhighpassSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
-    mhighpassSlider.setSkewFactor(0.5, false);
-    addAndMakeVisible(mhighpassSlider);
-    
-    //Lowpass
-    mlowpassSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
-    mlowpassSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
-    mlowpassSlider.setTextValueSuffix("Hz");
-    mlowpassSlider.setLookAndFeel(&sliderLookAndFeel);
-    mlowpassSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
-    mhighpassSlider.setSkewFactor(0.2, false);
-    addAndMakeVisible(mlowpassSlider);
-
-    //Drive
-    mDriveSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
-    mDriveSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
-    mDriveSlider.setLookAndFeel(&sliderLookAndFeel);
-    mDriveSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
-    mDriveSlider.setSkewFactor(0.5, false);
-    addAndMakeVisible(mDriveSlider);
-    
-    //DistortionType
-    mDistortionType.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
-    mDistortionType.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow,false,100,50);
-    mDistortionType.setLookAndFeel(&distLNF);
-    addAndMakeVisible(mDistortionType);
-
-    //DryWet
-    mDryWetSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
-    mDryWetSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
-    mDryWetSlider.setTextValueSuffix("%");
-    mDryWetSlider.setLookAndFeel(&sliderLookAndFeel);
-    mDryWetSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
-    addAndMakeVisible(mDryWetSlider);
-
-    //Volume
-    mVolumeSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
-    mVolumeSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
-    mVolumeSlider.setTextValueSuffix("dB");
-    mVolumeSlider.setLookAndFeel(&sliderLookAndFeel);
-    mVolumeSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
-    addAndMakeVisible(mVolumeSlider);
-
-    //HyperLink Button
-    mLearnMoreButton.setURL({ "http://www.juce.com" });
-    addAndMakeVisible(mLearnMoreButton);
-
-    //Auto makeup gain toggle
-    addAndMakeVisible(mMakeupGainToggle);
-    mMakeupGainToggle.setLookAndFeel(&buttonLNF);
-
-    
-    //Connecting the attachments to components
-    highpassSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "HIGHPASSCUTOFF", mhighpassSlider);
-    lowpassSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "LOWPASSCUTOFF", mlowpassSlider);
-    driveSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DRIVE", mDriveSlider);
-    dryWetSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DRYWET", mDryWetSlider);
-    volumeSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "VOLUME", mVolumeSlider);
-    distortionTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DISTORTIONTYPE", mDistortionType);
-    makeupGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "AUTOMAKEUPGAIN", mMakeupGainToggle);
-
-    
-    //Set the size of the plugin window
-    setSize(900, 450);
-}
-
-
-DeetzStortionAPVTSAudioProcessorEditor::~DeetzStortionAPVTSAudioProcessorEditor()
-{
-    setLookAndFeel(nullptr);
-}
-
-//==============================================================================
-void DeetzStortionAPVTSAudioProcessorEditor::paint (juce::Graphics& g)
-{
-}
-
-void DeetzStortionAPVTSAudioProcessorEditor::resized()
-{
-    //Setting the bounds of the objects in the GUI
-    background_image->setBounds(-1,-12,900,450);
-    mhighpassSlider.setBounds(60-2, 200, 100,100);
-    mlowpassSlider.setBounds(160-1, 200, 100, 100);
-    mDriveSlider.setBounds(340, 200, 100, 100);
-    mLearnMoreButton.setBounds(800, 420, 200, 30);
-    mDryWetSlider.setBounds(552,200, 100, 100);
-    mVolumeSlider.setBounds(755, 200, 100, 100);
-    mDistortionType.setBounds(312, 173, 126, 20);
-    mMakeupGainToggle.setBounds(739, 139, 11, 11);
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+DeetzStortionAPVTSAudioProcessorEditor::DeetzStortionAPVTSAudioProcessorEditor (DeetzStortionAPVTSAudioProcessor& p)
+    : AudioProcessorEditor (&p), diagnosticsOverlay (p.getTelemetry()), audioProcessor (p)
+{
+    //background properties
+    background_image = juce::Drawable::createFromImageData(BinaryData::pluginBackground_svg, BinaryData::pluginBackground_svgSize);
+    addAndMakeVisible(*background_image);
+    
+    //Highpass
+    mhighpassSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    mhighpassSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
+    mhighpassSlider.setSkewFactor(15.0f,true);
+    mhighpassSlider.setLookAndFeel(&sliderLookAndFeel);
+    mhighpassSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
+    mhighpassSlider.setSkewFactor(0.5, false);
+    addAndMakeVisible(mhighpassSlider);
+    
+    //Lowpass
+    mlowpassSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    mlowpassSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
+    mlowpassSlider.setTextValueSuffix("Hz");
+    mlowpassSlider.setLookAndFeel(&sliderLookAndFeel);
+    mlowpassSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
+    mhighpassSlider.setSkewFactor(0.2, false);
+    addAndMakeVisible(mlowpassSlider);
+
+    //Drive
+    mDriveSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    mDriveSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
+    mDriveSlider.setLookAndFeel(&sliderLookAndFeel);
+    mDriveSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
+    mDriveSlider.setSkewFactor(0.5, false);
+    addAndMakeVisible(mDriveSlider);
+    
+    //DistortionType
+    mDistortionType.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
+    mDistortionType.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow,false,100,50);
+    mDistortionType.setLookAndFeel(&distLNF);
+    addAndMakeVisible(mDistortionType);
+
+    //DryWet
+    mDryWetSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    mDryWetSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
+    mDryWetSlider.setTextValueSuffix("%");
+    mDryWetSlider.setLookAndFeel(&sliderLookAndFeel);
+    mDryWetSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
+    addAndMakeVisible(mDryWetSlider);
+
+    //Volume
+    mVolumeSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    mVolumeSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxBelow, true, 50, 25);
+    mVolumeSlider.setTextValueSuffix("dB");
+    mVolumeSlider.setLookAndFeel(&sliderLookAndFeel);
+    mVolumeSlider.setRotaryParameters(juce::degreesToRadians(0.f), juce::degreesToRadians(220.f), true);
+    addAndMakeVisible(mVolumeSlider);
+
+    //HyperLink Button
+    mLearnMoreButton.setURL({ "http://www.juce.com" });
+    addAndMakeVisible(mLearnMoreButton);
+
+    //Auto makeup gain toggle
+    addAndMakeVisible(mMakeupGainToggle);
+    mMakeupGainToggle.setLookAndFeel(&buttonLNF);
+
+    
+    //Connecting the attachments to components
+    highpassSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "HIGHPASSCUTOFF", mhighpassSlider);
+    lowpassSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "LOWPASSCUTOFF", mlowpassSlider);
+    driveSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DRIVE", mDriveSlider);
+    dryWetSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DRYWET", mDryWetSlider);
+    volumeSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "VOLUME", mVolumeSlider);
+    distortionTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "DISTORTIONTYPE", mDistortionType);
+    makeupGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "AUTOMAKEUPGAIN", mMakeupGainToggle);
+    morphSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "MORPH", mMorphSlider);
+    morphToggleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.apvts, "MORPHENABLE", mMorphToggle);
+
+    
+    //Presets. Selecting one goes through the same program change path the host uses.
+    mPresetBox.setTextWhenNothingSelected("Presets");
+    mPresetBox.onChange = [this] { audioProcessor.setCurrentProgram(mPresetBox.getSelectedId() - 1); };
+    addAndMakeVisible(mPresetBox);
+    mSavePresetButton.onClick = [this] { showSavePresetDialog(); };
+    addAndMakeVisible(mSavePresetButton);
+    audioProcessor.getPresetBank().addChangeListener(this);
+    refreshPresetList();
+
+    //Snapshots: click recalls, shift-click (or clicking an empty slot) stores
+    for (int slot = 0; slot < SnapshotMorph::numSnapshots; ++slot)
+    {
+        auto& button = mSnapshotButtons[(size_t) slot];
+        button.setButtonText(juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot)));
+        button.setClickingTogglesState(false);
+        button.onClick = [this, slot] { snapshotButtonClicked(slot); };
+        addAndMakeVisible(button);
+    }
+
+    mMorphSlider.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
+    mMorphSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::NoTextBox, true, 0, 0);
+    addAndMakeVisible(mMorphSlider);
+    addAndMakeVisible(mMorphToggle);
+
+    //Meters and scope. The processor only feeds them while the editor is open.
+    addAndMakeVisible(inputMeter);
+    addAndMakeVisible(outputMeter);
+    addAndMakeVisible(gainReductionMeter);
+    addAndMakeVisible(scopeView);
+    driveParameter = audioProcessor.apvts.getRawParameterValue("DRIVE");
+    distortionTypeParameter = audioProcessor.apvts.getRawParameterValue("DISTORTIONTYPE");
+    audioProcessor.getMeterFeed().addReader();
+    lastMeterUpdateMs = juce::Time::getMillisecondCounterHiRes();
+    startTimerHz(60);
+
+    //Diagnostics overlay, on top of everything else once shown
+    addChildComponent(diagnosticsOverlay);
+    setWantsKeyboardFocus(true);
+
+    //Set the size of the plugin window
+    setSize(900, 450);
+}
+
+
+DeetzStortionAPVTSAudioProcessorEditor::~DeetzStortionAPVTSAudioProcessorEditor()
+{
+    stopTimer();
+    audioProcessor.getPresetBank().removeChangeListener(this);
+    audioProcessor.getMeterFeed().removeReader();
+    setLookAndFeel(nullptr);
+}
+
+//==============================================================================
+void DeetzStortionAPVTSAudioProcessorEditor::paint (juce::Graphics& g)
+{
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::resized()
+{
+    //Setting the bounds of the objects in the GUI
+    background_image->setBounds(-1,-12,900,450);
+    mhighpassSlider.setBounds(60-2, 200, 100,100);
+    mlowpassSlider.setBounds(160-1, 200, 100, 100);
+    mDriveSlider.setBounds(340, 200, 100, 100);
+    mLearnMoreButton.setBounds(800, 420, 200, 30);
+    mDryWetSlider.setBounds(552,200, 100, 100);
+    mVolumeSlider.setBounds(755, 200, 100, 100);
+    mDistortionType.setBounds(312, 173, 126, 20);
+    mMakeupGainToggle.setBounds(739, 139, 11, 11);
+    diagnosticsOverlay.setBounds(20, 20, 360, 215);
+    inputMeter.setBounds(12, 110, 8, 220);
+    gainReductionMeter.setBounds(866, 110, 8, 220);
+    outputMeter.setBounds(880, 110, 8, 220);
+    scopeView.setBounds(300, 340, 300, 75);
+    mPresetBox.setBounds(20, 10, 200, 22);
+    mSavePresetButton.setBounds(225, 10, 50, 22);
+
+    for (int slot = 0; slot < SnapshotMorph::numSnapshots; ++slot)
+        mSnapshotButtons[(size_t) slot].setBounds(560 + slot * 28, 10, 24, 22);
+
+    mMorphSlider.setBounds(675, 10, 120, 22);
+    mMorphToggle.setBounds(800, 10, 80, 22);
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::changeListenerCallback (juce::ChangeBroadcaster*)
+{
+    refreshPresetList();
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::refreshPresetList()
+{
+    auto& bank = audioProcessor.getPresetBank();
+    mPresetBox.clear(juce::dontSendNotification);
+
+    for (int i = 0; i < bank.getNumPresets(); ++i)
+    {
+        //Factory presets first, then a divider before the user's own
+        if (i > 0 && bank.isFactoryPreset(i - 1) && ! bank.isFactoryPreset(i))
+            mPresetBox.addSeparator();
+
+        mPresetBox.addItem(bank.getPresetName(i), i + 1);
+    }
+
+    mPresetBox.setSelectedId(audioProcessor.getCurrentProgram() + 1, juce::dontSendNotification);
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::showSavePresetDialog()
+{
+    auto* dialog = new juce::AlertWindow("Save Preset", "Name for the new preset:", juce::AlertWindow::NoIcon);
+    dialog->addTextEditor("name", {});
+    dialog->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    dialog->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    //The dialog deletes itself once dismissed, by which time the editor may already be gone
+    juce::Component::SafePointer<DeetzStortionAPVTSAudioProcessorEditor> editor(this);
+
+    dialog->enterModalState(true, juce::ModalCallbackFunction::create([editor, dialog] (int result)
+    {
+        if (result == 1 && editor != nullptr)
+            editor->audioProcessor.saveUserPreset(dialog->getTextEditorContents("name"));
+    }), true);
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::snapshotButtonClicked (int slot)
+{
+    auto& snapshots = audioProcessor.getSnapshots();
+
+    if (juce::ModifierKeys::currentModifiers.isShiftDown() || ! snapshots.hasSnapshot(slot))
+        snapshots.capture(slot);
+    else
+        snapshots.recall(slot);
+}
+
+void DeetzStortionAPVTSAudioProcessorEditor::timerCallback()
+{
+    //A 60Hz timer stands in for a vblank callback. Every component only repaints the part
+    //that changed, so an idle editor doesn't redraw anything.
+    const auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = (nowMs - lastMeterUpdateMs) * 0.001;
+    lastMeterUpdateMs = nowMs;
+
+    //Loudest of everything since the last tick
+    float inputPeak = 0.0f, inputRms = 0.0f, outputPeak = 0.0f, outputRms = 0.0f, gainReduction = 0.0f;
+
+    audioProcessor.getMeterFeed().popFrames([&] (const MeterFeed::Frame& frame)
+    {
+        inputPeak = juce::jmax(inputPeak, frame.inputPeak);
+        inputRms = juce::jmax(inputRms, frame.inputRms);
+        outputPeak = juce::jmax(outputPeak, frame.outputPeak);
+        outputRms = juce::jmax(outputRms, frame.outputRms);
+        gainReduction = juce::jmax(gainReduction, frame.gainReductionDecibels);
+        scopeView.pushFrame(frame);
+    });
+
+    using juce::Decibels;
+    inputMeter.update(Decibels::gainToDecibels(inputPeak, -100.0f), Decibels::gainToDecibels(inputRms, -100.0f), elapsedSeconds);
+    outputMeter.update(Decibels::gainToDecibels(outputPeak, -100.0f), Decibels::gainToDecibels(outputRms, -100.0f), elapsedSeconds);
+    gainReductionMeter.update(gainReduction, gainReduction, elapsedSeconds);
+
+    scopeView.flush();
+    scopeView.setCurve(Distortion::modeFromParameter(distortionTypeParameter->load()), driveParameter->load());
+
+    //Follow program changes the host made, and light up the filled snapshot slots.
+    //Both only repaint when something actually changed.
+    const auto programId = audioProcessor.getCurrentProgram() + 1;
+
+    if (mPresetBox.getSelectedId() != programId)
+        mPresetBox.setSelectedId(programId, juce::dontSendNotification);
+
+    for (int slot = 0; slot < SnapshotMorph::numSnapshots; ++slot)
+        mSnapshotButtons[(size_t) slot].setToggleState(audioProcessor.getSnapshots().hasSnapshot(slot), juce::dontSendNotification);
+}
+
+bool DeetzStortionAPVTSAudioProcessorEditor::keyPressed (const juce::KeyPress& key)
+{
+    if (key == juce::KeyPress('d', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0))
+    {
+        diagnosticsOverlay.setVisible(! diagnosticsOverlay.isVisible());
+        diagnosticsOverlay.toFront(false);
+        return true;
+    }
+
+    return false;
+}
@@ -1,360 +1,945 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-#define _USE_MATH_DEFINES
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-#include <cmath>
-
-
-//==============================================================================
-DeetzStortionAPVTSAudioProcessor::DeetzStortionAPVTSAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       ), apvts(*this,nullptr,"Parameters",createParameters())
-#endif
-{
-    apvts.state = juce::ValueTree("savedParams");
-    oversampling.reset(new juce::dsp::Oversampling<float>(2, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, false));
-
-}
-
-DeetzStortionAPVTSAudioProcessor::~DeetzStortionAPVTSAudioProcessor()
-{
-    oversampling.reset();
-}
-
-//==============================================================================
-const juce::String DeetzStortionAPVTSAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool DeetzStortionAPVTSAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool DeetzStortionAPVTSAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool DeetzStortionAPVTSAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double DeetzStortionAPVTSAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int DeetzStortionAPVTSAudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int DeetzStortionAPVTSAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void DeetzStortionAPVTSAudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String DeetzStortionAPVTSAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void DeetzStortionAPVTSAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void DeetzStortionAPVTSAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    
-    //Initializing various DSP blocks and other components 
-    oversampling->reset();
-    oversampling->initProcessing(static_cast<size_t> (samplesPerBlock));
-
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock*3;
-    spec.sampleRate = sampleRate*4;
-    spec.numChannels = getTotalNumOutputChannels();
-    highPass.prepare(spec);
-    lowPass.prepare(spec);
-    compressor.prepare(spec);
-    reset();
-
-
-}
-
-void DeetzStortionAPVTSAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool DeetzStortionAPVTSAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-
-void DeetzStortionAPVTSAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    //define parameters in relation to the audio processor value tree state
-    float highPassCutoff = *apvts.getRawParameterValue("HIGHPASSCUTOFF");
-    float lowPassCutoff = *apvts.getRawParameterValue("LOWPASSCUTOFF");
-    float drive = *apvts.getRawParameterValue("DRIVE");
-    float dryWet = *apvts.getRawParameterValue("DRYWET");
-    float volume = *apvts.getRawParameterValue("VOLUME");
-    float distortionType = *apvts.getRawParameterValue("DISTORTIONTYPE");
-    bool makeupGainEngaged = *apvts.getRawParameterValue("AUTOMAKEUPGAIN");
-   
-    //FILTER
-    highPass.setCutoffFrequency(highPassCutoff);
-    lowPass.setCutoffFrequency(lowPassCutoff);
-    highPass.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    lowPass.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-
-    //COMPRESSOR
-    compressor.setAttack(10.0f);
-    compressor.setRelease(50.0f);
-    compressor.setRatio(4.0f);
-    compressor.setThreshold(-4.0f);
-
-    
-    //OVERSAMPLING
-    juce::dsp::AudioBlock<float> blockInput(buffer);
-    juce::dsp::AudioBlock<float> blockOuput = oversampling->processSamplesUp(blockInput);
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-
-
-    auto audioBlock = juce::dsp::AudioBlock<float>(buffer);
-    auto context = juce::dsp::ProcessContextReplacing<float>(blockOuput);
-    highPass.process(context);
-    lowPass.process(context);
-
-    
-    //Messy ass signal processing block because it was my first coded plugin 8^/
-    for (int channel = 0; channel < blockOuput.getNumChannels(); channel++) {
-        for (int sample = 0; sample < blockOuput.getNumSamples(); sample++) {
-            
-            float in = blockOuput.getSample(channel, sample);
-            float cleanSig = in;
-            //Distortion Type
-            //Input Gain (Not for Full wave and Half wave rectifier)
-            if (distortionType == 1 || distortionType == 2 || distortionType == 3 || distortionType == 4 || distortionType == 5) {
-                in *= drive;
-            }
-            float out;
-            if (distortionType == 1) {
-                // Simple hard clipping
-                float threshold = 1.0f;
-                if (in > threshold)
-                    out = threshold;
-                else if (in < -threshold)
-                    out = -threshold;
-                else
-                    out = in;
-
-            }
-            else if (distortionType == 2) {
-                // Soft clipping based on quadratic function
-                float threshold1 = 1.0f / 3.0f;
-                float threshold2 = 2.0f / 3.0f;
-                if (in > threshold2)
-                    out = 1.0f;
-                else if (in > threshold1)
-                    out = (3.0f - (2.0f - 3.0f * in) *
-                        (2.0f - 3.0f * in)) / 3.0f;
-                else if (in < -threshold2)
-                    out = -1.0f;
-                else if (in < -threshold1)
-                    out = -(3.0f - (2.0f + 3.0f * in) *
-                        (2.0f + 3.0f * in)) / 3.0f;
-                else
-                    out = 2.0f * in;
-
-            }
-            else if (distortionType == 3)
-            {
-                // Soft clipping based on exponential function
-                if (in > 0)
-                    out = 1.0f - expf(-in);
-                else
-                    out = -1.0f + expf(in);
-
-                out = out * 1.5f;
-
-            }
-            else if (distortionType == 4) {
-                // ArcTan
-                out = (2.0f / M_PI) * atan(in);
-            }
-            else if (distortionType == 5) {
-                // tubeIsh Distortion
-                
-                out = compressor.processSample(channel,in);
-
-                tanh(out);
-                float x = out * 0.25;
-                float a = abs(x);
-                float x2 = x * x;
-                float y = 1 - 1 / (1 + a + x2 + 0.66422417311781 * x2 * a + 0.36483285408241 * x2 * x2);
-                if (x >= 0)
-                {
-                    out = y;
-                }
-                else
-                {
-                    out = -y;
-                }
-                
-                out = out * 3.0f;
-
-            }
-            out = (((out * (dryWet / 100.0f)) + (cleanSig * (1.0f - (dryWet / 100.0f)))) * juce::Decibels::decibelsToGain(volume));
-            
-            
-            if (makeupGainEngaged)
-            {
-                //Automatic Gain Comp
-                makeUpGain = pow(drive, 0.65);
-                out /= makeUpGain;
-                blockOuput.setSample(channel, sample, out);
-            }
-            
-            else
-            {
-                blockOuput.setSample(channel, sample, out);
-            }
-        }
-    }
-    oversampling->processSamplesDown(blockInput);
-
-}
-
-
-//==============================================================================
-bool DeetzStortionAPVTSAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* DeetzStortionAPVTSAudioProcessor::createEditor()
-{
-    return new DeetzStortionAPVTSAudioProcessorEditor (*this);
-}
-
-//==============================================================================
-void DeetzStortionAPVTSAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    std::unique_ptr<juce::XmlElement> xml(apvts.state.createXml());
-
-    copyXmlToBinary(*xml, destData);
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-}
-
-void DeetzStortionAPVTSAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    // Storing the parameters for recall in XML
-    std::unique_ptr<juce::XmlElement> savedParameters(getXmlFromBinary(data, sizeInBytes));
-
-    if (savedParameters != nullptr)
-    {
-        if (savedParameters->hasTagName(apvts.state.getType()))
-        {
-            apvts.state = juce::ValueTree::fromXml(*savedParameters);
-        }
-    }
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new DeetzStortionAPVTSAudioProcessor();
-}
-
-juce::AudioProcessorValueTreeState::ParameterLayout DeetzStortionAPVTSAudioProcessor::createParameters()
-{
-    // Management of the APVTS object storing and releasing plugin parameter data
-    std::vector < std::unique_ptr < juce::RangedAudioParameter>> params;
-
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("HIGHPASSCUTOFF", "HighPassCutoff",20.0f,5000.0f, 1.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("LOWPASSCUTOFF", "LowPassCutoff", 100.0f, 20000.0f, 20000.0f));
-
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("DRIVE", "Drive", 1.0f, 25.0f, 1.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("DRYWET", "DryWet", 1.0f,100.0f, 100.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("VOLUME", "Volume", -60.0f,1.0f, 1.0f));
-    params.push_back(std::make_unique<juce::AudioParameterInt>("DISTORTIONTYPE", "DistortionType",1,5,1));
-    params.push_back(std::make_unique<juce::AudioParameterBool>("AUTOMAKEUPGAIN", "AutoMakeupGain",false));
-    
-
-    return { params.begin(), params.end()};
-}
-
-void DeetzStortionAPVTSAudioProcessor::reset()
-{
-    highPass.reset();
-    lowPass.reset();
-    compressor.reset();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+#define _USE_MATH_DEFINES
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include <cmath>
+
+constexpr float DeetzStortionAPVTSAudioProcessor::dryWetMinimum;
+
+//==============================================================================
+DeetzStortionAPVTSAudioProcessor::DeetzStortionAPVTSAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ), apvts(*this,nullptr,"Parameters",createParameters())
+#endif
+{
+    apvts.state = juce::ValueTree("savedParams");
+
+    //Cache the parameter atomics once so the audio thread never looks them up by name. The DSP
+    //reads them through the snapshot morph, which passes them straight on unless morphing.
+    highPassCutoffParameter = snapshotMorph.getValue("HIGHPASSCUTOFF");
+    lowPassCutoffParameter = snapshotMorph.getValue("LOWPASSCUTOFF");
+    driveParameter = snapshotMorph.getValue("DRIVE");
+    dryWetParameter = snapshotMorph.getValue("DRYWET");
+    volumeParameter = snapshotMorph.getValue("VOLUME");
+    distortionTypeParameter = snapshotMorph.getValue("DISTORTIONTYPE");
+    makeupGainParameter = snapshotMorph.getValue("AUTOMAKEUPGAIN");
+    oversamplingParameter = snapshotMorph.getValue("OVERSAMPLING");
+    oversamplingFilterParameter = snapshotMorph.getValue("OVERSAMPLINGFILTER");
+    offlineQualityParameter = snapshotMorph.getValue("OFFLINEQUALITY");
+    antialiasingParameter = snapshotMorph.getValue("ANTIALIASING");
+    shaperEngineParameter = snapshotMorph.getValue("SHAPERENGINE");
+    compThresholdParameter = snapshotMorph.getValue("COMPTHRESHOLD");
+    compRatioParameter = snapshotMorph.getValue("COMPRATIO");
+    compAttackParameter = snapshotMorph.getValue("COMPATTACK");
+    compReleaseParameter = snapshotMorph.getValue("COMPRELEASE");
+    compRateParameter = snapshotMorph.getValue("COMPRATE");
+    compLinkParameter = snapshotMorph.getValue("COMPLINK");
+    filterPlacementParameter = snapshotMorph.getValue("FILTERPLACEMENT");
+    multibandParameter = snapshotMorph.getValue("MULTIBAND");
+    morphParameter = apvts.getRawParameterValue("MORPH");
+    morphEnableParameter = apvts.getRawParameterValue("MORPHENABLE");
+
+    for (size_t i = 0; i < crossoverParameters.size(); ++i)
+        crossoverParameters[i] = snapshotMorph.getValue("CROSSOVER" + juce::String(i + 1));
+
+    for (size_t i = 0; i < bandDriveParameters.size(); ++i)
+    {
+        const auto band = "BAND" + juce::String(i + 1);
+        bandDriveParameters[i] = snapshotMorph.getValue(band + "DRIVE");
+        bandTypeParameters[i] = snapshotMorph.getValue(band + "TYPE");
+        bandMixParameters[i] = snapshotMorph.getValue(band + "MIX");
+        bandBypassParameters[i] = snapshotMorph.getValue(band + "BYPASS");
+        bandOversamplingParameters[i] = snapshotMorph.getValue(band + "OVERSAMPLING");
+    }
+
+    //Profiling scripts can have every instance dump its telemetry as JSON once a second
+    const auto telemetryDirectory = juce::SystemStats::getEnvironmentVariable("DEETZ_TELEMETRY_DIR", {});
+
+    if (telemetryDirectory.isNotEmpty())
+        telemetryDumpFile = juce::File(telemetryDirectory).getChildFile("deetzStortion-" + juce::Uuid().toString() + ".json");
+
+    presetBank->addChangeListener(this);
+    startTimerHz(20);
+}
+
+DeetzStortionAPVTSAudioProcessor::~DeetzStortionAPVTSAudioProcessor()
+{
+    presetBank->removeChangeListener(this);
+    stopTimer();
+}
+
+void DeetzStortionAPVTSAudioProcessor::timerCallback()
+{
+    //Picks up latency changes the audio thread made, e.g. from switching oversampling factor
+    const auto latency = pendingLatencySamples.load();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    loadPendingProgram();
+
+    if (telemetryDumpFile != juce::File() && ++telemetryDumpTicks >= 20)
+    {
+        telemetryDumpTicks = 0;
+        telemetryDumpFile.replaceWithText(telemetry.toJson());
+    }
+}
+
+//==============================================================================
+const juce::String DeetzStortionAPVTSAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool DeetzStortionAPVTSAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool DeetzStortionAPVTSAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool DeetzStortionAPVTSAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double DeetzStortionAPVTSAudioProcessor::getTailLengthSeconds() const
+{
+    //The filters need the longest to ring out (a 20Hz highpass takes ~200ms to fall 120dB),
+    //plus whatever the oversampler and dry path delay the signal by
+    return filterTailSeconds + getWetLatencyInSamples() / baseSampleRate;
+}
+
+int DeetzStortionAPVTSAudioProcessor::getNumPrograms()
+{
+    //Factory presets are always there, so this is never 0
+    return juce::jmax(1, presetBank->getNumPresets());
+}
+
+int DeetzStortionAPVTSAudioProcessor::getCurrentProgram()
+{
+    return currentProgram.load();
+}
+
+void DeetzStortionAPVTSAudioProcessor::setCurrentProgram (int index)
+{
+    //Can come from the audio thread, so the preset is loaded later on the message thread
+    currentProgram = index;
+    pendingProgram = index;
+}
+
+const juce::String DeetzStortionAPVTSAudioProcessor::getProgramName (int index)
+{
+    return presetBank->getPresetName(index);
+}
+
+void DeetzStortionAPVTSAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+    //Preset names are their file names, renaming is done by saving under the new name
+    juce::ignoreUnused(index, newName);
+}
+
+void DeetzStortionAPVTSAudioProcessor::loadPendingProgram()
+{
+    const auto program = pendingProgram.exchange(-1);
+
+    if (program < 0)
+        return;
+
+    juce::MemoryBlock state;
+
+    if (presetBank->getPresetState(program, state))
+    {
+        //Through the parameters, so the smoothing and the mode crossfade cover the switch
+        setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        currentProgram = program;
+    }
+    else if (! presetBank->isIndexed())
+    {
+        //A user preset the bank hasn't read yet, try again next tick unless something newer came in
+        auto expected = -1;
+        pendingProgram.compare_exchange_strong(expected, program);
+    }
+}
+
+bool DeetzStortionAPVTSAudioProcessor::saveUserPreset (const juce::String& name)
+{
+    juce::MemoryBlock state;
+    getStateInformation(state);
+    return presetBank->saveUserPreset(name, state);
+}
+
+void DeetzStortionAPVTSAudioProcessor::changeListenerCallback (juce::ChangeBroadcaster*)
+{
+    //The preset list changed, hosts re-read the program names
+    updateHostDisplay();
+}
+
+//==============================================================================
+void DeetzStortionAPVTSAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    
+    //Initializing various DSP blocks and other components 
+    //The chain only ever sees sub-blocks (see processInChunks), so it's sized for those whatever
+    //the host's block size. That keeps a 16x block of one channel at 8kB.
+    juce::ignoreUnused(samplesPerBlock);
+    baseSampleRate = sampleRate;
+    subBlockPosition = 0;
+
+    //Pick up the current parameter values, morphed or not, before anything below reads them
+    snapshotMorph.prepare(sampleRate);
+    snapshotMorph.process(morphParameter->load(), morphEnableParameter->load() > 0.5f, 0);
+
+    //Every oversampling setting is built up front so switching while playing never allocates
+    oversampling.prepare(getTotalNumOutputChannels(), subBlockSize);
+    driveRamp.allocate(static_cast<size_t> (subBlockSize * OversamplingStage::maxFactor), true);
+    gainRamp.allocate(static_cast<size_t> (subBlockSize), true);
+
+    //The dry path is mixed back in at the host rate, delayed to line up with the oversampler
+    juce::dsp::ProcessSpec baseSpec;
+    baseSpec.maximumBlockSize = static_cast<juce::uint32> (subBlockSize);
+    baseSpec.sampleRate = sampleRate;
+    baseSpec.numChannels = static_cast<juce::uint32> (getTotalNumOutputChannels());
+    dryWetMixer.prepare(baseSpec);
+    dryWetMixer.setMixingRule(juce::dsp::DryWetMixingRule::linear);
+    //Set ahead of the reset below, which snaps the mixer's smoothing to it rather than
+    //ramping in from fully wet on the first block
+    dryWetMixer.setWetMixProportion(dryWetParameter->load() / 100.0f);
+    dryDelay.prepare(baseSpec);
+    dryBuffer.setSize(getTotalNumOutputChannels(), subBlockSize);
+    latencyDelay.prepare(baseSpec);
+    hostRateDynamics.prepare(baseSpec);
+
+    //Channel links follow the bus layout, e.g. L/R, Ls/Rs and the height pairs of a 7.1.4 bed
+    for (size_t link = 0; link < channelLinkGroups.size(); ++link)
+        channelLinkGroups[link] = DynamicsStage::makeChannelGroups(getChannelLayoutOfBus(false, 0), getTotalNumOutputChannels(),
+                                                                   static_cast<DynamicsStage::Linking>(link));
+
+    multiband.prepare(baseSpec);
+
+    //Filters placed around the oversampler run at the host rate
+    for (auto* filters : { &preFilters, &postFilters })
+    {
+        filters->prepare(baseSpec);
+        filters->resetSmoothing(sampleRate);
+    }
+    fastPathBuffer.setSize(getTotalNumOutputChannels(), subBlockSize);
+    fullPathGain.reset(sampleRate, 0.02);
+    fullPathGain.setCurrentAndTargetValue(1.0f);
+    silenceDetector.prepare(sampleRate);
+    isSleeping = false;
+
+    //Everything after the upsampler is prepared once at the highest oversampled rate.
+    //Switching factor then only rescales cutoffs and time constants (see getRateScale),
+    //so filter and compressor state carries straight across the switch.
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = static_cast<juce::uint32> (subBlockSize * OversamplingStage::maxFactor);
+    spec.sampleRate = sampleRate * OversamplingStage::maxFactor;
+    spec.numChannels = static_cast<juce::uint32> (getTotalNumOutputChannels());
+    oversampledFilters.prepare(spec);
+    waveshaper.prepare(spec);
+
+    //Saving once sizes the crossfade state slots, so saving on the audio thread never allocates
+    for (auto& state : oversampledFilterStates)
+        oversampledFilters.saveState(state);
+
+    for (auto& state : waveshaperStates)
+        waveshaper.saveState(state);
+
+    reset();
+
+    updateOversampling();
+    waveshaper.setRateScale(getRateScale());
+    oversampledFilters.setRateScale(getRateScale());
+    resetSmoothing();
+    updateLatency();
+
+    //Not on the audio thread here, so the host can hear about it straight away
+    setLatencySamples(pendingLatencySamples.load());
+}
+
+void DeetzStortionAPVTSAudioProcessor::updateOversampling()
+{
+    int factorIndex = juce::roundToInt(oversamplingParameter->load());
+    auto quality = static_cast<OversamplingStage::FilterQuality>(juce::roundToInt(oversamplingFilterParameter->load()));
+
+    //Bounces get the highest quality path: max oversampling, linear phase filters, exact maths
+    const bool renderOffline = isNonRealtime() && offlineQualityParameter->load() > 0.5f;
+
+    if (renderOffline)
+    {
+        factorIndex = OversamplingStage::numFactors - 1;
+        quality = OversamplingStage::FilterQuality::linearPhase;
+    }
+
+    waveshaper.setUseFastApproximations(! renderOffline);
+    hostRateDynamics.setUseFastApproximations(! renderOffline);
+
+    //The mode and engine decide whether ADAA runs at all, so they're set here with the
+    //antialiasing, ahead of the latency check below
+    const auto antialiasing = static_cast<Distortion::Antialiasing>(juce::roundToInt(antialiasingParameter->load()));
+    waveshaper.setAntialiasing(antialiasing);
+    waveshaper.setMode(Distortion::modeFromParameter(distortionTypeParameter->load()));
+    waveshaper.setEngine(static_cast<Distortion::Engine>(juce::roundToInt(shaperEngineParameter->load())));
+
+    if (oversampling.select(factorIndex, quality))
+    {
+        waveshaper.setRateScale(getRateScale());
+        oversampledFilters.setRateScale(getRateScale());
+        resetSmoothing();
+    }
+
+    //MULTIBAND
+    //Each band picks its own factor, with the same offline override as the broadband path
+    const int multibandIndex = juce::roundToInt(multibandParameter->load());
+    multibandActive = multibandIndex > 0;
+
+    if (multibandActive)
+    {
+        multiband.setNumBands(multibandIndex + 1);
+        multiband.setOversamplingQuality(quality);
+        multiband.setUseFastApproximations(! renderOffline);
+        multiband.setAntialiasing(antialiasing);
+        multiband.setEngine(static_cast<Distortion::Engine>(juce::roundToInt(shaperEngineParameter->load())));
+
+        for (int i = 0; i < MultibandStage::maxBands - 1; ++i)
+            multiband.setCrossover(i, crossoverParameters[(size_t) i]->load());
+
+        for (int i = 0; i < MultibandStage::maxBands; ++i)
+        {
+            MultibandStage::BandSettings settings;
+            settings.drive = bandDriveParameters[(size_t) i]->load();
+            settings.mode = Distortion::modeFromParameter(bandTypeParameters[(size_t) i]->load());
+            settings.mix = bandMixParameters[(size_t) i]->load() / 100.0f;
+            settings.bypassed = bandBypassParameters[(size_t) i]->load() > 0.5f;
+            settings.oversamplingIndex = renderOffline ? OversamplingStage::numFactors - 1
+                                                       : juce::roundToInt(bandOversamplingParameters[(size_t) i]->load());
+            multiband.setBand(i, settings);
+        }
+    }
+
+    //Oversampling, ADAA, the shaper's mode and engine and the band layout all feed into the latency
+    if (getWetLatencyInSamples() != currentWetLatency)
+        updateLatency();
+}
+
+void DeetzStortionAPVTSAudioProcessor::updateLatency()
+{
+    //The dry path and the reported latency follow the oversampler plus whatever ADAA adds.
+    //Both delays crossfade to the new alignment over the same block the oversampler does.
+    const auto wetLatency = getWetLatencyInSamples();
+    currentWetLatency = wetLatency;
+    dryDelay.setDelay(wetLatency);
+    latencyDelay.setDelay(wetLatency);
+    pendingLatencySamples = juce::roundToInt(wetLatency);
+}
+
+float DeetzStortionAPVTSAudioProcessor::getWetLatencyInSamples() const noexcept
+{
+    if (multibandActive)
+        return multiband.getLatencyInSamples();
+
+    //ADAA delays at the oversampled rate, so it's a fraction of a host sample
+    return oversampling.getExactLatencyInSamples()
+         + waveshaper.getLatencyInSamples() / static_cast<float> (oversampling.getFactor());
+}
+
+void DeetzStortionAPVTSAudioProcessor::resetSmoothing()
+{
+    //The oversampled cutoffs and drive tick at the oversampled rate, so they're re-timed whenever
+    //the factor changes. Volume is applied after downsampling and ticks at the host rate.
+    const auto smoothingRate = baseSampleRate * oversampling.getFactor();
+
+    oversampledFilters.setCutoffs(highPassCutoffParameter->load(), lowPassCutoffParameter->load());
+    oversampledFilters.resetSmoothing(smoothingRate);
+    driveSmoothed.reset(smoothingRate, 0.05);
+    volumeSmoothed.reset(baseSampleRate, 0.05);
+
+    driveSmoothed.setCurrentAndTargetValue(driveParameter->load());
+    volumeSmoothed.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(volumeParameter->load()));
+}
+
+float DeetzStortionAPVTSAudioProcessor::getRateScale() const noexcept
+{
+    //Ratio between the rate the oversampled processors were prepared at and the rate they're actually run at
+    return static_cast<float> (OversamplingStage::maxFactor) / static_cast<float> (oversampling.getFactor());
+}
+
+void DeetzStortionAPVTSAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool DeetzStortionAPVTSAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // Any layout works, named or discrete, from mono up to a 7.1.4 bed.
+    // Every stage processes however many channels it was prepared with.
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    if (output.isDisabled() || output.size() > maxChannels)
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+
+void DeetzStortionAPVTSAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    RealtimeSafety::ScopedAudioThread audioThread;
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    telemetry.beginBlock();
+    processInChunks(buffer, false);
+    telemetry.endBlock(buffer.getNumSamples(), baseSampleRate, oversampling.getFactor());
+}
+
+void DeetzStortionAPVTSAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    RealtimeSafety::ScopedAudioThread audioThread;
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    telemetry.beginBlock();
+    processInChunks(buffer, true);
+    telemetry.endBlock(buffer.getNumSamples(), baseSampleRate, oversampling.getFactor());
+}
+
+void DeetzStortionAPVTSAudioProcessor::processInChunks (juce::AudioBuffer<float>& buffer, bool bypassed)
+{
+    //Host blocks are cut on a fixed grid of subBlockSize samples that carries on across calls.
+    //Parameters, smoothing targets and mode switches are picked up once per sub-block, so a
+    //render comes out the same whatever block sizes the host sends, and none of the scratch
+    //buffers can be overrun by a block bigger than the host promised.
+    const auto numSamples = buffer.getNumSamples();
+
+    //The meters see each sub-block on its way in and on its way out, while the editor is open
+    auto processMeteredChunk = [this, bypassed] (juce::AudioBuffer<float>& chunk)
+    {
+        //Parameter values, morphed or not, are fixed for the whole sub-block
+        snapshotMorph.process(morphParameter->load(), morphEnableParameter->load() > 0.5f, chunk.getNumSamples());
+
+        const bool metering = meterFeed.isActive();
+
+        if (metering)
+            meterFeed.measureInput(chunk);
+
+        currentGainReduction = 0.0f;
+        processChunk(chunk, bypassed);
+
+        if (metering)
+            meterFeed.measureOutput(chunk, currentGainReduction);
+    };
+
+    for (int start = 0; start < numSamples;)
+    {
+        const auto length = juce::jmin(subBlockSize - subBlockPosition, numSamples - start);
+
+        if (length == numSamples)
+        {
+            processMeteredChunk(buffer);
+        }
+        else
+        {
+            juce::AudioBuffer<float> chunk (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, length);
+            processMeteredChunk(chunk);
+        }
+
+        start += length;
+        subBlockPosition = (subBlockPosition + length) % subBlockSize;
+    }
+}
+
+void DeetzStortionAPVTSAudioProcessor::processChunk (juce::AudioBuffer<float>& buffer, bool bypassed)
+{
+    //Bypassed output still has to carry the reported latency
+    if (bypassed)
+    {
+        processWithFastPath(buffer, false, false);
+        return;
+    }
+
+    //Once the input has been silent for longer than every tail, the full path sleeps
+    silenceDetector.setHoldTime(getTailLengthSeconds());
+
+    if (silenceDetector.process(buffer))
+    {
+        if (! isSleeping)
+        {
+            //Fully decayed state is the same as reset state, so waking up again won't click
+            reset();
+            isSleeping = true;
+        }
+
+        //Whatever is left below -120 dB, like a dither floor, still comes out, time aligned,
+        //rather than being swapped for zeros. The delay costs next to nothing.
+        processLatencyPath(buffer, true);
+        return;
+    }
+
+    isSleeping = false;
+
+    //DRYWET bottoms out at 1%, its original range, so automation saved against that range still
+    //lands where it did. The minimum counts as fully dry: a no-op apart from the output gain,
+    //so it gets the cheap path.
+    const bool isNoOp = dryWetParameter->load() <= dryWetMinimum;
+    processWithFastPath(buffer, ! isNoOp, true);
+}
+
+void DeetzStortionAPVTSAudioProcessor::processWithFastPath (juce::AudioBuffer<float>& buffer, bool shouldProcess, bool applyOutputGain)
+{
+    fullPathGain.setTargetValue(shouldProcess ? 1.0f : 0.0f);
+
+    if (! fullPathGain.isSmoothing())
+    {
+        if (shouldProcess)
+            processFullPath(buffer);
+        else
+            processLatencyPath(buffer, applyOutputGain);
+
+        return;
+    }
+
+    //Fading between the two: the latency-only path renders into a scratch copy, then the
+    //full path is blended in on top of it
+    const auto numChannels = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        fastPathBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+    juce::AudioBuffer<float> fastPath (fastPathBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    processLatencyPath(fastPath, applyOutputGain);
+    processFullPath(buffer);
+
+    for (int i = 0; i < numSamples; ++i)
+        gainRamp[i] = fullPathGain.getNextValue();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* out = buffer.getWritePointer(channel);
+        const auto* fast = fastPath.getReadPointer(channel);
+
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = fast[i] + gainRamp[i] * (out[i] - fast[i]);
+    }
+
+    //Start the full path from a clean state next time it fades in
+    if (! fullPathGain.isSmoothing() && ! shouldProcess)
+        resetFullPath();
+}
+
+void DeetzStortionAPVTSAudioProcessor::processLatencyPath (juce::AudioBuffer<float>& buffer, bool applyOutputGain)
+{
+    juce::dsp::AudioBlock<float> block(buffer);
+    latencyDelay.process(block);
+
+    if (applyOutputGain)
+    {
+        //Multiband applies makeup per band, so there's none to match here
+        const auto makeupGain = makeupGainParameter->load() > 0.5f && ! multibandActive ? OutputStage::getMakeupGain(driveParameter->load()) : 1.0f;
+        block.multiplyBy(juce::Decibels::decibelsToGain(volumeParameter->load()) * makeupGain);
+    }
+}
+
+void DeetzStortionAPVTSAudioProcessor::processFullPath (juce::AudioBuffer<float>& buffer)
+{
+    //Picks up oversampling changes and switches to offline quality when the host bounces
+    updateOversampling();
+
+    //define parameters in relation to the audio processor value tree state
+    const float highPassCutoff = highPassCutoffParameter->load();
+    const float lowPassCutoff = lowPassCutoffParameter->load();
+
+    for (auto* filters : { &oversampledFilters, &preFilters, &postFilters })
+        filters->setCutoffs(highPassCutoff, lowPassCutoff);
+
+    driveSmoothed.setTargetValue(driveParameter->load());
+    dryWetMixer.setWetMixProportion(dryWetParameter->load() / 100.0f);
+    volumeSmoothed.setTargetValue(juce::Decibels::decibelsToGain(volumeParameter->load()));
+    float distortionType = distortionTypeParameter->load();
+    bool makeupGainEngaged = makeupGainParameter->load() > 0.5f;
+
+    //Multiband has its own per-band drive and makeup, and runs at the host rate throughout
+    multiband.setMakeupGainEngaged(makeupGainEngaged);
+
+    if (multibandActive)
+        makeupGainEngaged = false;
+
+    using Placement = FilterStage::Placement;
+    const auto filterPlacement = static_cast<Placement>(juce::roundToInt(filterPlacementParameter->load()));
+    const bool filterOversampled = filterPlacement == Placement::preDriveOversampled && ! multibandActive;
+    const bool filterPreDrive = filterPlacement == Placement::preDrive || filterPlacement == Placement::preAndPostDrive
+                             || (filterPlacement == Placement::preDriveOversampled && multibandActive);
+    const bool filterPostDrive = filterPlacement == Placement::postDrive || filterPlacement == Placement::preAndPostDrive;
+
+
+    //DRY PATH
+    juce::dsp::AudioBlock<float> blockInput(buffer);
+    auto dryBlock = juce::dsp::AudioBlock<float>(dryBuffer).getSubsetChannelBlock(0, blockInput.getNumChannels())
+                                                           .getSubBlock(0, blockInput.getNumSamples());
+    dryBlock.copyFrom(blockInput);
+    dryDelay.process(dryBlock);
+    dryWetMixer.pushDrySamples(dryBlock);
+
+
+    //PRE-DRIVE FILTER
+    //At the host rate the filters cost 1/factor of what they do oversampled
+    auto stageStart = Telemetry::now();
+
+    if (filterPreDrive)
+        preFilters.process(blockInput);
+    else
+        preFilters.reset();
+
+    telemetry.addStageTime(Telemetry::Stage::filters, stageStart);
+
+
+    //CHANNEL LINKING
+    //Only copies anything when the selection changes
+    const auto& linkGroups = channelLinkGroups[(size_t) juce::jlimit(0, 2, juce::roundToInt(compLinkParameter->load()))];
+    waveshaper.setChannelGroups(linkGroups);
+    hostRateDynamics.setChannelGroups(linkGroups);
+    multiband.setChannelGroups(linkGroups);
+
+
+    //DISTORTION
+    //Either the broadband chain, or the band split with its own chain per band
+    const bool driveIsSmoothing = ! multibandActive && driveSmoothed.isSmoothing();
+
+    if (multibandActive)
+    {
+        multiband.setDynamics(compThresholdParameter->load(), compRatioParameter->load(),
+                              compAttackParameter->load(), compReleaseParameter->load());
+        stageStart = Telemetry::now();
+        multiband.process(blockInput);
+        currentGainReduction = multiband.getGainReductionDecibels();
+        oversampledFilters.reset();
+
+        //The bands have their own drives, but the broadband one keeps moving so switching
+        //back doesn't ramp from wherever it was left. It ticks at the oversampled rate.
+        driveSmoothed.skip(static_cast<int> (blockInput.getNumSamples()) * oversampling.getFactor());
+        telemetry.addStageTime(Telemetry::Stage::multiband, stageStart);
+    }
+    else
+    {
+        processBroadband(blockInput, distortionType, filterOversampled, driveIsSmoothing);
+    }
+
+
+    //POST-DRIVE FILTER
+    stageStart = Telemetry::now();
+
+    if (filterPostDrive)
+        postFilters.process(blockInput);
+    else
+        postFilters.reset();
+
+    telemetry.addStageTime(Telemetry::Stage::filters, stageStart);
+
+
+    //MIX AND OUTPUT GAIN
+    //Back at the host rate: blend in the latency-aligned dry signal, then apply volume and makeup
+    dryWetMixer.mixWetSamples(blockInput);
+
+    const auto numBaseSamples = static_cast<int> (blockInput.getNumSamples());
+    const auto factor = oversampling.getFactor();
+
+    if (volumeSmoothed.isSmoothing() || (makeupGainEngaged && driveIsSmoothing))
+    {
+        for (int i = 0; i < numBaseSamples; ++i)
+        {
+            const auto drive = driveIsSmoothing ? driveRamp[i * factor] : driveSmoothed.getTargetValue();
+            gainRamp[i] = volumeSmoothed.getNextValue() * (makeupGainEngaged ? OutputStage::getMakeupGain(drive) : 1.0f);
+        }
+
+        outputStage.setGainRamp(gainRamp.get());
+    }
+    else
+    {
+        const auto makeupGain = makeupGainEngaged ? OutputStage::getMakeupGain(driveSmoothed.getTargetValue()) : 1.0f;
+        outputStage.setGain(volumeSmoothed.getTargetValue() * makeupGain);
+    }
+
+    outputStage.process(blockInput);
+
+}
+
+
+void DeetzStortionAPVTSAudioProcessor::processBroadband (juce::dsp::AudioBlock<float>& block, float distortionType,
+                                                         bool filterOversampled, bool driveIsSmoothing)
+{
+    //DYNAMICS
+    //tubeIsh compresses ahead of its curve. Settings only cost anything when they change.
+    //At the host rate it runs here on 1/factor of the samples, with drive folded into the
+    //detector since drive is a plain gain until the curve. With the filters oversampled, the
+    //detector sees the signal before them.
+    const float compThreshold = compThresholdParameter->load();
+    const float compRatio = compRatioParameter->load();
+    const float compAttack = compAttackParameter->load();
+    const float compRelease = compReleaseParameter->load();
+    const bool dynamicsAtHostRate = compRateParameter->load() > 0.5f;
+
+    waveshaper.setDynamics(compThreshold, compRatio, compAttack, compRelease);
+    waveshaper.setUseInternalDynamics(! dynamicsAtHostRate);
+
+    auto stageStart = Telemetry::now();
+
+    if (dynamicsAtHostRate && Distortion::modeFromParameter(distortionType) == Distortion::Mode::tubeIsh)
+    {
+        hostRateDynamics.setThreshold(compThreshold);
+        hostRateDynamics.setRatio(compRatio);
+        hostRateDynamics.setAttack(compAttack);
+        hostRateDynamics.setRelease(compRelease);
+        hostRateDynamics.process(block, driveSmoothed.getCurrentValue());
+    }
+
+    stageStart = telemetry.addStageTime(Telemetry::Stage::dynamics, stageStart);
+
+    //OVERSAMPLING
+    //Right after the factor or filter quality changes, the stage runs the filter and shaper
+    //below twice, once at the outgoing factor and once at the incoming one, and crossfades
+    //the two. Whatever depends on the rate follows the factor each run is given, and each
+    //run keeps its own filter and shaper state in the slots below. The shaper's mode and
+    //engine were set in updateOversampling, as they move the latency.
+    const auto activeFactor = oversampling.getFactor();
+
+    //The drive ramp is timed for the active factor, so it's worked out once up front
+    if (driveIsSmoothing)
+        for (int i = 0; i < static_cast<int> (block.getNumSamples()) * activeFactor; ++i)
+            driveRamp[i] = driveSmoothed.getNextValue();
+
+    oversampling.process(block, [&] (juce::dsp::AudioBlock<float>& blockOuput, int factor, OversamplingStage::Run run)
+    {
+        const auto rateScale = static_cast<float> (OversamplingStage::maxFactor) / static_cast<float> (factor);
+        waveshaper.setRateScale(rateScale);
+        oversampledFilters.setRateScale(rateScale);
+        stageStart = telemetry.addStageTime(Telemetry::Stage::upsample, stageStart);
+
+
+        //FILTER
+        auto context = juce::dsp::ProcessContextReplacing<float>(blockOuput);
+
+        if (filterOversampled)
+            oversampledFilters.process(blockOuput);
+        else
+            oversampledFilters.reset();
+
+        stageStart = telemetry.addStageTime(Telemetry::Stage::filters, stageStart);
+
+
+        //WAVESHAPER
+        //The outgoing and pre-roll runs hold the drive at its target
+        if (driveIsSmoothing && run == OversamplingStage::Run::active)
+            waveshaper.setDriveRamp(driveRamp.get());
+        else
+            waveshaper.setDrive(driveSmoothed.getTargetValue());
+
+        waveshaper.process(context);
+        stageStart = telemetry.addStageTime(Telemetry::Stage::shaper, stageStart);
+    },
+    [this] (OversamplingStage::StateSlot slot)
+    {
+        oversampledFilters.saveState(oversampledFilterStates[(size_t) slot]);
+        waveshaper.saveState(waveshaperStates[(size_t) slot]);
+    },
+    [this] (OversamplingStage::StateSlot slot)
+    {
+        oversampledFilters.restoreState(oversampledFilterStates[(size_t) slot]);
+        waveshaper.restoreState(waveshaperStates[(size_t) slot]);
+    });
+
+    if (Distortion::modeFromParameter(distortionType) == Distortion::Mode::tubeIsh)
+        currentGainReduction = dynamicsAtHostRate ? hostRateDynamics.getGainReductionDecibels() : waveshaper.getGainReductionDecibels();
+
+    //DOWNSAMPLING
+    //Everything since the last shaper run
+    telemetry.addStageTime(Telemetry::Stage::downsample, stageStart);
+}
+
+//==============================================================================
+bool DeetzStortionAPVTSAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* DeetzStortionAPVTSAudioProcessor::createEditor()
+{
+    return new DeetzStortionAPVTSAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void DeetzStortionAPVTSAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    //Compact binary: a hash and a value per parameter, the custom curve and the morph snapshots
+    StateSerializer::Extras extras;
+    extras.customCurve = getCustomCurve();
+
+    for (int slot = 0; slot < SnapshotMorph::numSnapshots; ++slot)
+        extras.snapshots.push_back(snapshotMorph.getSnapshotValues(slot));
+
+    stateSerializer.save(destData, extras);
+}
+
+void DeetzStortionAPVTSAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    //Applied parameter by parameter rather than swapping apvts.state, so the audio thread
+    //never sees a half-replaced tree. XML states from older versions are migrated.
+    //A program change the host made before restoring the state mustn't land on top of it
+    pendingProgram = -1;
+
+    StateSerializer::Extras extras;
+
+    if (! stateSerializer.load(data, sizeInBytes, extras))
+        return;
+
+    if (extras.hasCustomCurve)
+        setCustomCurve(extras.customCurve);
+
+    //Only the slots the state carries, presets without snapshots leave them alone
+    for (size_t slot = 0; slot < extras.snapshots.size(); ++slot)
+        snapshotMorph.setSnapshotValues(static_cast<int>(slot), extras.snapshots[slot]);
+}
+
+void DeetzStortionAPVTSAudioProcessor::setCustomCurve (const std::vector<std::pair<float, float>>& points)
+{
+    //Stored as "input:output" pairs so the curve travels with the rest of the state
+    apvts.state.setProperty(customCurveProperty, StateSerializer::curveToString(points), nullptr);
+    waveshaper.setCustomCurve(CurveTable::makeCurveFromPoints(points));
+}
+
+std::vector<std::pair<float, float>> DeetzStortionAPVTSAudioProcessor::getCustomCurve() const
+{
+    return StateSerializer::curveFromString(apvts.state.getProperty(customCurveProperty).toString());
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new DeetzStortionAPVTSAudioProcessor();
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout DeetzStortionAPVTSAudioProcessor::createParameters()
+{
+    // Management of the APVTS object storing and releasing plugin parameter data
+    std::vector < std::unique_ptr < juce::RangedAudioParameter>> params;
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("HIGHPASSCUTOFF", "HighPassCutoff",20.0f,5000.0f, 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("LOWPASSCUTOFF", "LowPassCutoff", 100.0f, 20000.0f, 20000.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("DRIVE", "Drive", 1.0f, 25.0f, 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("DRYWET", "DryWet", dryWetMinimum,100.0f, 100.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("VOLUME", "Volume", -60.0f,1.0f, 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterInt>("DISTORTIONTYPE", "DistortionType",1,5,1));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("AUTOMAKEUPGAIN", "AutoMakeupGain",false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("OVERSAMPLING", "Oversampling", OversamplingStage::getFactorNames(), 2));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("OVERSAMPLINGFILTER", "OversamplingFilter", OversamplingStage::getQualityNames(), 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("OFFLINEQUALITY", "OfflineQuality", true));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("ANTIALIASING", "Antialiasing", Distortion::getAntialiasingNames(), 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("SHAPERENGINE", "ShaperEngine", Distortion::getEngineNames(), 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("FILTERPLACEMENT", "FilterPlacement", FilterStage::getPlacementNames(), 0));
+
+    //tubeIsh's compressor, defaulting to its original fixed settings
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("COMPTHRESHOLD", "CompThreshold", -40.0f, 0.0f, -4.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("COMPRATIO", "CompRatio", juce::NormalisableRange<float>(1.0f, 20.0f, 0.0f, 0.5f), 4.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("COMPATTACK", "CompAttack", juce::NormalisableRange<float>(0.1f, 100.0f, 0.0f, 0.4f), 10.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("COMPRELEASE", "CompRelease", juce::NormalisableRange<float>(5.0f, 1000.0f, 0.0f, 0.4f), 50.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("COMPRATE", "CompRate", juce::StringArray { "Oversampled", "Host Rate" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("COMPLINK", "CompLink", DynamicsStage::getLinkingNames(), 0));
+
+    //Multiband: off, or 2-4 bands, each with its own drive, mode, mix, bypass and oversampling.
+    //The low band defaults to 1x, it rarely needs more.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("MULTIBAND", "Multiband", juce::StringArray { "Off", "2 Bands", "3 Bands", "4 Bands" }, 0));
+
+    const float crossoverDefaults[] = { 200.0f, 1000.0f, 5000.0f };
+
+    for (int i = 0; i < MultibandStage::maxBands - 1; ++i)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>("CROSSOVER" + juce::String(i + 1), "Crossover" + juce::String(i + 1),
+                                                                     juce::NormalisableRange<float>(20.0f, 20000.0f, 0.0f, 0.25f), crossoverDefaults[i]));
+
+    for (int i = 0; i < MultibandStage::maxBands; ++i)
+    {
+        const auto id = "BAND" + juce::String(i + 1);
+        const auto name = "Band" + juce::String(i + 1);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(id + "DRIVE", name + "Drive", 1.0f, 25.0f, 1.0f));
+        params.push_back(std::make_unique<juce::AudioParameterInt>(id + "TYPE", name + "Type", 1, 5, 1));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(id + "MIX", name + "Mix", 0.0f, 100.0f, 100.0f));
+        params.push_back(std::make_unique<juce::AudioParameterBool>(id + "BYPASS", name + "Bypass", false));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(id + "OVERSAMPLING", name + "Oversampling", OversamplingStage::getFactorNames(), i == 0 ? 0 : 2));
+    }
+
+    //Morph across the A/B/C/D snapshots: 0 is A, 3 is D
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MORPH", "Morph", 0.0f, 3.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("MORPHENABLE", "MorphEnable", false));
+
+
+    return { params.begin(), params.end()};
+}
+
+void DeetzStortionAPVTSAudioProcessor::reset()
+{
+    resetFullPath();
+    latencyDelay.reset();
+}
+
+void DeetzStortionAPVTSAudioProcessor::resetFullPath()
+{
+    oversampling.reset();
+    for (auto* filters : { &oversampledFilters, &preFilters, &postFilters })
+        filters->reset();
+    waveshaper.reset();
+    hostRateDynamics.reset();
+    multiband.reset();
+    dryWetMixer.reset();
+    dryDelay.reset();
+}
@@ -1,80 +1,234 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-//==============================================================================
-/**
-*/
-class DeetzStortionAPVTSAudioProcessor  : public juce::AudioProcessor
-{
-public:
-    //==============================================================================
-    DeetzStortionAPVTSAudioProcessor();
-    ~DeetzStortionAPVTSAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-    void updateFilter();
-
-    juce::AudioProcessorValueTreeState apvts;
-
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
-
-
-private:
-    void reset() override;
-
-
-    juce::dsp::StateVariableTPTFilter<float> highPass;
-    juce::dsp::StateVariableTPTFilter<float> lowPass;
-    juce::dsp::Compressor<float> compressor;
-
-    
-    double makeUpGain;
-
-
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
-
-
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeetzStortionAPVTSAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Waveshaper.h"
+#include "OversamplingStage.h"
+#include "OutputStage.h"
+#include "SilenceDetector.h"
+#include "DynamicsStage.h"
+#include "RealtimeSafety.h"
+#include "Telemetry.h"
+#include "MeterFeed.h"
+#include "StateSerializer.h"
+#include "SnapshotMorph.h"
+#include "PresetBank.h"
+#include "FilterStage.h"
+#include "MultibandStage.h"
+#include "AlignmentDelay.h"
+
+//==============================================================================
+/**
+*/
+class DeetzStortionAPVTSAudioProcessor  : public juce::AudioProcessor,
+                                          private juce::Timer,
+                                          private juce::ChangeListener
+{
+public:
+    //==============================================================================
+    DeetzStortionAPVTSAudioProcessor();
+    ~DeetzStortionAPVTSAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    /** Loads a drawn or imported transfer curve for the Custom Curve engine, as (input, output)
+        points. The points are saved with the plugin state. Message thread only. */
+    void setCustomCurve (const std::vector<std::pair<float, float>>& points);
+    std::vector<std::pair<float, float>> getCustomCurve() const;
+
+    void updateFilter();
+
+    /** CPU counters for this instance, read by the diagnostics overlay. */
+    Telemetry& getTelemetry() noexcept    { return telemetry; }
+
+    /** Levels, gain reduction and scope data for the editor's meters. */
+    MeterFeed& getMeterFeed() noexcept    { return meterFeed; }
+
+    /** The A/B/C/D snapshots the MORPH parameter moves between. */
+    SnapshotMorph& getSnapshots() noexcept    { return snapshotMorph; }
+
+    /** Factory and user presets, shared by every instance. */
+    PresetBank& getPresetBank() noexcept    { return *presetBank; }
+
+    /** Saves the current state as a user preset. Message thread only. */
+    bool saveUserPreset (const juce::String& name);
+
+    juce::AudioProcessorValueTreeState apvts;
+
+    OversamplingStage oversampling;
+
+
+private:
+    void timerCallback() override;
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+    void loadPendingProgram();
+    void reset() override;
+    void resetFullPath();
+    void processInChunks (juce::AudioBuffer<float>& buffer, bool bypassed);
+    void processChunk (juce::AudioBuffer<float>& buffer, bool bypassed);
+    void processWithFastPath (juce::AudioBuffer<float>& buffer, bool shouldProcess, bool applyOutputGain);
+    void processLatencyPath (juce::AudioBuffer<float>& buffer, bool applyOutputGain);
+    void processFullPath (juce::AudioBuffer<float>& buffer);
+    void processBroadband (juce::dsp::AudioBlock<float>& block, float distortionType, bool filterOversampled, bool driveIsSmoothing);
+    void updateOversampling();
+    void updateLatency();
+    void resetSmoothing();
+    float getRateScale() const noexcept;
+    float getWetLatencyInSamples() const noexcept;
+
+
+    //Tone filters, one pair for each place FILTERPLACEMENT can put them. Idle pairs are held reset.
+    FilterStage oversampledFilters, preFilters, postFilters;
+    Waveshaper waveshaper;
+    //Where the oversampling stage keeps the oversampled filters' and shaper's state while it
+    //crossfades a factor switch, one of each per OversamplingStage::StateSlot
+    std::array<FilterStage::State, OversamplingStage::numStateSlots> oversampledFilterStates;
+    std::array<Waveshaper::State, OversamplingStage::numStateSlots> waveshaperStates;
+    DynamicsStage hostRateDynamics;
+    //COMPLINK's channel groups for the current layout, one set per option, built in prepareToPlay
+    std::array<std::vector<int>, 3> channelLinkGroups;
+    MultibandStage multiband;
+    bool multibandActive = false;
+    OutputStage outputStage;
+
+    //The dry path is delayed by dryDelay before it reaches the mixer, so a latency change
+    //crossfades to the new alignment instead of jumping
+    juce::dsp::DryWetMixer<float> dryWetMixer;
+    AlignmentDelay dryDelay;
+    juce::AudioBuffer<float> dryBuffer;
+
+    //When the effect is a no-op (bypassed or fully dry) only this delay runs, so the output
+    //still lines up with the reported latency. fullPathGain fades between the two.
+    AlignmentDelay latencyDelay;
+    float currentWetLatency = -1.0f;
+    //Latency worked out on the audio thread, reported to the host from the message thread since
+    //setLatencySamples takes the listener lock
+    std::atomic<int> pendingLatencySamples { 0 };
+    juce::AudioBuffer<float> fastPathBuffer;
+    juce::SmoothedValue<float> fullPathGain;
+
+    //Per-block and per-stage timings. With DEETZ_TELEMETRY_DIR set they're also written there.
+    Telemetry telemetry;
+    juce::File telemetryDumpFile;
+    int telemetryDumpTicks = 0;
+
+    //Only measures anything while the editor is open
+    MeterFeed meterFeed;
+    //tubeIsh's gain reduction in the current sub-block, 0 in any other mode
+    float currentGainReduction = 0.0f;
+
+    //Idle instances stop processing once silent input has outlasted the tail
+    SilenceDetector silenceDetector;
+    bool isSleeping = false;
+    static constexpr double filterTailSeconds = 0.2;
+
+    //Property on the state tree holding the custom curve's points
+    const juce::Identifier customCurveProperty { "customCurve" };
+
+    //Binary save and recall through the parameter objects. Declared after apvts, so
+    //every parameter exists by the time it indexes them.
+    StateSerializer stateSerializer { *this };
+
+    //Every parameter the DSP reads comes through here, so it can be morphed. Settings that
+    //change the latency aren't morphed.
+    SnapshotMorph snapshotMorph { apvts, { "MORPH", "MORPHENABLE", "OVERSAMPLING", "OVERSAMPLINGFILTER", "OFFLINEQUALITY", "ANTIALIASING",
+                                           "BAND1OVERSAMPLING", "BAND2OVERSAMPLING", "BAND3OVERSAMPLING", "BAND4OVERSAMPLING" } };
+
+    //Host program changes can arrive on any thread, including the audio thread, so they're
+    //only recorded there and loaded from the bank on the message thread timer
+    juce::SharedResourcePointer<PresetBank> presetBank;
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<int> pendingProgram { -1 };
+
+    
+    //Cached parameter values, read lock-free on the audio thread
+    std::atomic<float>* highPassCutoffParameter = nullptr;
+    std::atomic<float>* lowPassCutoffParameter = nullptr;
+    std::atomic<float>* driveParameter = nullptr;
+    std::atomic<float>* dryWetParameter = nullptr;
+    //DRYWET's lowest value, which is treated as fully dry
+    static constexpr float dryWetMinimum = 1.0f;
+    std::atomic<float>* volumeParameter = nullptr;
+    std::atomic<float>* distortionTypeParameter = nullptr;
+    std::atomic<float>* makeupGainParameter = nullptr;
+    std::atomic<float>* oversamplingParameter = nullptr;
+    std::atomic<float>* oversamplingFilterParameter = nullptr;
+    std::atomic<float>* offlineQualityParameter = nullptr;
+    std::atomic<float>* antialiasingParameter = nullptr;
+    std::atomic<float>* shaperEngineParameter = nullptr;
+    std::atomic<float>* compThresholdParameter = nullptr;
+    std::atomic<float>* compRatioParameter = nullptr;
+    std::atomic<float>* compAttackParameter = nullptr;
+    std::atomic<float>* compReleaseParameter = nullptr;
+    std::atomic<float>* compRateParameter = nullptr;
+    std::atomic<float>* compLinkParameter = nullptr;
+    std::atomic<float>* filterPlacementParameter = nullptr;
+    std::atomic<float>* multibandParameter = nullptr;
+    std::atomic<float>* morphParameter = nullptr;
+    std::atomic<float>* morphEnableParameter = nullptr;
+    std::array<std::atomic<float>*, MultibandStage::maxBands - 1> crossoverParameters {};
+    std::array<std::atomic<float>*, MultibandStage::maxBands> bandDriveParameters {}, bandTypeParameters {}, bandMixParameters {},
+                                                               bandBypassParameters {}, bandOversamplingParameters {};
+
+    //Smoothed versions of the continuous parameters. Dry/wet is smoothed inside the DryWetMixer,
+    //the cutoffs inside the FilterStages.
+    juce::SmoothedValue<float> driveSmoothed, volumeSmoothed;
+
+    //Per-sample ramps for the smoothed values. Drive runs oversampled, the output gain at the host rate.
+    juce::HeapBlock<float> driveRamp, gainRamp;
+
+    //Largest bus accepted, enough for a 7.1.4 bed
+    static constexpr int maxChannels = 12;
+
+    double baseSampleRate = 44100.0;
+    //Host blocks are processed as sub-blocks of at most this many samples, on a fixed grid.
+    //subBlockPosition is how far into the current grid cell the last host block ended.
+    static constexpr int subBlockSize = 128;
+    int subBlockPosition = 0;
+
+
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
+
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeetzStortionAPVTSAudioProcessor)
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+#include "StateSerializer.h"
+
+PresetBank::PresetBank()
+    : juce::Thread ("deetzStortion preset index")
+{
+    presets = makeFactoryPresets();
+    numPresets = static_cast<int> (presets.size());
+    // Below the default priority, indexing is never urgent
+    startThread (3);
+}
+
+PresetBank::~PresetBank()
+{
+    stopThread (2000);
+}
+
+juce::File PresetBank::getUserPresetDirectory()
+{
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+               .getChildFile ("deetzStortion")
+               .getChildFile ("Presets");
+}
+
+std::vector<PresetBank::Preset> PresetBank::makeFactoryPresets()
+{
+    // Only what differs from the defaults, everything else loads at its default
+    const std::pair<const char*, std::vector<std::pair<juce::String, float>>> definitions[] = {
+        { "Init", {} },
+        { "Gentle Saturation", { { "DISTORTIONTYPE", 4.0f }, { "DRIVE", 2.5f }, { "AUTOMAKEUPGAIN", 1.0f } } },
+        { "Warm Tube",         { { "DISTORTIONTYPE", 5.0f }, { "DRIVE", 6.0f }, { "COMPTHRESHOLD", -12.0f }, { "COMPRATIO", 3.0f },
+                                 { "LOWPASSCUTOFF", 9000.0f }, { "AUTOMAKEUPGAIN", 1.0f } } },
+        { "Parallel Crunch",   { { "DISTORTIONTYPE", 2.0f }, { "DRIVE", 12.0f }, { "DRYWET", 40.0f }, { "HIGHPASSCUTOFF", 120.0f } } },
+        { "Fuzz Wall",         { { "DISTORTIONTYPE", 1.0f }, { "DRIVE", 20.0f }, { "LOWPASSCUTOFF", 7000.0f }, { "VOLUME", -12.0f },
+                                 { "ANTIALIASING", 1.0f } } },
+        { "Split Bass Drive",  { { "MULTIBAND", 1.0f }, { "CROSSOVER1", 150.0f }, { "BAND1DRIVE", 1.5f }, { "BAND1TYPE", 4.0f },
+                                 { "BAND2DRIVE", 10.0f }, { "BAND2TYPE", 5.0f }, { "AUTOMAKEUPGAIN", 1.0f } } }
+    };
+
+    std::vector<Preset> factory;
+
+    for (auto& definition : definitions)
+        factory.push_back ({ definition.first, StateSerializer::makeState (definition.second), true });
+
+    return factory;
+}
+
+//==============================================================================
+juce::String PresetBank::getPresetName (int index) const
+{
+    const juce::ScopedLock scopedLock (lock);
+    return juce::isPositiveAndBelow (index, static_cast<int> (presets.size())) ? presets[(size_t) index].name : juce::String();
+}
+
+bool PresetBank::isFactoryPreset (int index) const
+{
+    const juce::ScopedLock scopedLock (lock);
+    return juce::isPositiveAndBelow (index, static_cast<int> (presets.size())) && presets[(size_t) index].isFactory;
+}
+
+bool PresetBank::getPresetState (int index, juce::MemoryBlock& state) const
+{
+    const juce::ScopedLock scopedLock (lock);
+
+    if (! juce::isPositiveAndBelow (index, static_cast<int> (presets.size())))
+        return false;
+
+    state = presets[(size_t) index].state;
+    return true;
+}
+
+bool PresetBank::saveUserPreset (const juce::String& name, const juce::MemoryBlock& state)
+{
+    const auto fileName = juce::File::createLegalFileName (name.trim());
+
+    if (fileName.isEmpty())
+        return false;
+
+    const auto directory = getUserPresetDirectory();
+
+    if (! directory.createDirectory())
+        return false;
+
+    if (! directory.getChildFile (fileName + getFileExtension()).replaceWithData (state.getData(), state.getSize()))
+        return false;
+
+    rescan();
+    return true;
+}
+
+void PresetBank::rescan()
+{
+    notify();
+}
+
+//==============================================================================
+void PresetBank::run()
+{
+    while (! threadShouldExit())
+    {
+        // Read every user preset, then swap the whole list in at once
+        auto files = getUserPresetDirectory().findChildFiles (juce::File::findFiles, false, "*" + getFileExtension());
+        std::sort (files.begin(), files.end(), [] (const juce::File& a, const juce::File& b)
+        {
+            return a.getFileName().compareNatural (b.getFileName()) < 0;
+        });
+
+        std::vector<Preset> userPresets;
+
+        for (auto& file : files)
+        {
+            if (threadShouldExit())
+                return;
+
+            Preset preset;
+            preset.name = file.getFileNameWithoutExtension();
+
+            if (file.loadFileAsData (preset.state) && preset.state.getSize() > 0)
+                userPresets.push_back (std::move (preset));
+        }
+
+        {
+            const juce::ScopedLock scopedLock (lock);
+            presets.erase (std::remove_if (presets.begin(), presets.end(), [] (const Preset& p) { return ! p.isFactory; }), presets.end());
+            std::move (userPresets.begin(), userPresets.end(), std::back_inserter (presets));
+            numPresets = static_cast<int> (presets.size());
+        }
+
+        indexed = true;
+        sendChangeMessage();
+
+        // Sleep until someone saves a preset or asks for a rescan
+        wait (-1);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    The factory presets followed by the user's, as the host's program list.
+
+    Factory presets are built in. User presets are state blobs (see StateSerializer)
+    saved as files in getUserPresetDirectory(). A background thread indexes that
+    directory and reads every preset into memory, so recalling one is a copy and
+    never touches the disk. Presets are a few hundred bytes, so holding them all is
+    cheap.
+
+    Meant to be shared through juce::SharedResourcePointer. However many instances a
+    project has, the directory is only read once, and a preset saved from one
+    instance shows up in all of them. Listeners are told whenever the list changes.
+
+    Everything here is for the message thread or the bank's own thread. The audio
+    thread never calls in, the processor hands host program changes over first.
+*/
+class PresetBank : public juce::ChangeBroadcaster,
+                   private juce::Thread
+{
+public:
+    PresetBank();
+    ~PresetBank() override;
+
+    static juce::File getUserPresetDirectory();
+    static juce::String getFileExtension()    { return ".dzpreset"; }
+
+    /** Never less than the number of factory presets, user presets follow once indexed. */
+    int getNumPresets() const noexcept    { return numPresets.load(); }
+    bool isIndexed() const noexcept    { return indexed.load(); }
+
+    juce::String getPresetName (int index) const;
+    bool isFactoryPreset (int index) const;
+
+    /** Copies a preset's state blob out. Returns false for an index that doesn't exist (yet). */
+    bool getPresetState (int index, juce::MemoryBlock& state) const;
+
+    /** Writes a user preset, replacing one with the same name, and reindexes. */
+    bool saveUserPreset (const juce::String& name, const juce::MemoryBlock& state);
+
+    /** Reindexes the user presets in the background. */
+    void rescan();
+
+private:
+    struct Preset
+    {
+        juce::String name;
+        juce::MemoryBlock state;
+        bool isFactory = false;
+    };
+
+    void run() override;
+    static std::vector<Preset> makeFactoryPresets();
+
+    mutable juce::CriticalSection lock;
+    std::vector<Preset> presets;
+    std::atomic<int> numPresets { 0 };
+    std::atomic<bool> indexed { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBank)
+};
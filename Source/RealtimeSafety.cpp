@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafety.h"
+
+#if DEETZ_REALTIME_SAFETY_CHECKS
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if ! JUCE_WINDOWS
+ #include <pthread.h>
+ #include <unistd.h>
+#endif
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+#endif
+
+namespace
+{
+    // Plain thread_locals. In an executable these are reached without allocating,
+    // which matters since the hooks below read them on every malloc.
+    thread_local int audioThreadDepth = 0;
+    thread_local bool isReporting = false;
+
+    std::atomic<int> numViolations { 0 };
+    std::atomic<bool> abortOnViolation { true };
+
+    void writeToStderr (const char* text) noexcept
+    {
+       #if JUCE_WINDOWS
+        std::fputs (text, stderr);
+       #else
+        juce::ignoreUnused (::write (STDERR_FILENO, text, std::strlen (text)));
+       #endif
+    }
+
+    void report (const char* what) noexcept
+    {
+        if (audioThreadDepth == 0 || isReporting)
+            return;
+
+        // Anything the report itself does mustn't come back round here
+        isReporting = true;
+        ++numViolations;
+
+        writeToStderr ("RealtimeSafety: ");
+        writeToStderr (what);
+        writeToStderr (" called on the audio thread\n");
+
+        isReporting = false;
+
+        if (abortOnViolation.load())
+            std::abort();
+    }
+}
+
+void RealtimeSafety::enterAudioThread() noexcept    { ++audioThreadDepth; }
+void RealtimeSafety::exitAudioThread() noexcept     { --audioThreadDepth; }
+int RealtimeSafety::getNumViolations() noexcept     { return numViolations.load(); }
+
+void RealtimeSafety::setAbortOnViolation (bool shouldAbort) noexcept
+{
+    abortOnViolation = shouldAbort;
+}
+
+//==============================================================================
+#if JUCE_LINUX
+// glibc exports its allocator under these names, so the replacements can forward to
+// it without dlsym (which allocates). operator new ends up in malloc here, so it
+// doesn't need replacing separately.
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+
+    void* malloc (size_t size) noexcept
+    {
+        report ("malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t numElements, size_t size) noexcept
+    {
+        report ("calloc");
+        return __libc_calloc (numElements, size);
+    }
+
+    void* realloc (void* pointer, size_t size) noexcept
+    {
+        report ("realloc");
+        return __libc_realloc (pointer, size);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size) noexcept
+    {
+        report ("aligned_alloc");
+        return __libc_memalign (alignment, size);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t size) noexcept
+    {
+        report ("posix_memalign");
+        *result = __libc_memalign (alignment, size);
+        return *result != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void free (void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            report ("free");
+
+        __libc_free (pointer);
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept;
+}
+
+namespace
+{
+    using MutexLockFunction = int (*) (pthread_mutex_t*);
+
+    MutexLockFunction getRealMutexLock() noexcept
+    {
+        // The lock has no __libc_ alias to link against. Looked up once, and startup
+        // locks plenty of mutexes, so it's resolved long before any audio thread runs.
+        static const auto function = reinterpret_cast<MutexLockFunction> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+        return function;
+    }
+}
+
+int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+{
+    report ("pthread_mutex_lock");
+    return getRealMutexLock() (mutex);
+}
+
+#else
+// Elsewhere there's no portable way to get under malloc, so this catches everything
+// that goes through operator new and delete, which covers the containers.
+void* operator new (std::size_t size)
+{
+    report ("operator new");
+
+    if (auto* pointer = std::malloc (size > 0 ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    report ("operator new");
+    return std::malloc (size > 0 ? size : 1);
+}
+
+void* operator new[] (std::size_t size)                                   { return operator new (size); }
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept    { return operator new (size, tag); }
+
+void operator delete (void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        report ("operator delete");
+
+    std::free (pointer);
+}
+
+void operator delete (void* pointer, const std::nothrow_t&) noexcept      { operator delete (pointer); }
+void operator delete[] (void* pointer) noexcept                           { operator delete (pointer); }
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept    { operator delete (pointer); }
+void operator delete (void* pointer, std::size_t) noexcept                { operator delete (pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept              { operator delete (pointer); }
+#endif
+
+#endif
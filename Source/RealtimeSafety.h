@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    RealtimeSafety.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Debug instrumentation that catches the audio thread allocating or locking.
+
+    processBlock marks its thread with a ScopedAudioThread. With
+    DEETZ_REALTIME_SAFETY_CHECKS=1 the build replaces the allocator (and, on Linux,
+    malloc and pthread_mutex_lock too), and any of them called from a marked thread
+    counts as a violation, prints what happened to stderr and aborts.
+
+    The hooks replace process-wide symbols, so this is for the benchmark harness and
+    debug builds only. Leave it off in anything that ships: in a plugin the hooks
+    would sit in the host's allocator path too. With it off, ScopedAudioThread
+    compiles to nothing.
+*/
+#ifndef DEETZ_REALTIME_SAFETY_CHECKS
+ #define DEETZ_REALTIME_SAFETY_CHECKS 0
+#endif
+
+namespace RealtimeSafety
+{
+    constexpr bool isEnabled() noexcept    { return DEETZ_REALTIME_SAFETY_CHECKS != 0; }
+
+   #if DEETZ_REALTIME_SAFETY_CHECKS
+    void enterAudioThread() noexcept;
+    void exitAudioThread() noexcept;
+
+    /** Violations caught so far, across every thread. */
+    int getNumViolations() noexcept;
+
+    /** Aborting is the default. Turn it off to count violations instead, e.g. to report
+        every one a test run hits. */
+    void setAbortOnViolation (bool shouldAbort) noexcept;
+   #else
+    inline void enterAudioThread() noexcept {}
+    inline void exitAudioThread() noexcept {}
+    inline int getNumViolations() noexcept                  { return 0; }
+    inline void setAbortOnViolation (bool) noexcept         {}
+   #endif
+
+    /** Marks the calling thread as the audio thread while in scope. Nests. */
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept     { enterAudioThread(); }
+        ~ScopedAudioThread() noexcept    { exitAudioThread(); }
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedAudioThread)
+    };
+}
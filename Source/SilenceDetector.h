@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    SilenceDetector.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Watches the input for digital silence so an idle instance can stop processing.
+
+    It only reports silence once the input has stayed below -120 dB for longer than
+    the hold time (set this to the processor's tail), and wakes up on the first block
+    with anything above that. There's deliberately no hysteresis: a louder wake level
+    would leave quiet material between the two levels treated as silence.
+*/
+class SilenceDetector
+{
+public:
+    SilenceDetector() = default;
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        silentSamples = 0;
+        isAsleep = false;
+    }
+
+    void setHoldTime (double seconds) noexcept
+    {
+        holdSamples = static_cast<juce::int64> (seconds * sampleRate);
+    }
+
+    /** Feeds a block of input in. Returns true while the processor can sleep. */
+    bool process (const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        const auto numSamples = buffer.getNumSamples();
+        bool blockIsSilent = true;
+
+        for (int channel = 0; channel < buffer.getNumChannels() && blockIsSilent; ++channel)
+            blockIsSilent = buffer.getMagnitude (channel, 0, numSamples) <= silenceThreshold;
+
+        if (! blockIsSilent)
+        {
+            silentSamples = 0;
+            isAsleep = false;
+            return false;
+        }
+
+        silentSamples = juce::jmin (silentSamples + numSamples, holdSamples + 1);
+        isAsleep = silentSamples > holdSamples;
+        return isAsleep;
+    }
+
+    bool isSleeping() const noexcept    { return isAsleep; }
+
+private:
+    // -120 dB, both to fall asleep and to wake back up
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    double sampleRate = 44100.0;
+    juce::int64 holdSamples = 0;
+    juce::int64 silentSamples = 0;
+    bool isAsleep = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilenceDetector)
+};
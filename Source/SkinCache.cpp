@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    SkinCache.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "SkinCache.h"
+
+SkinCache::SkinCache()
+    : knob (juce::Drawable::createFromImageData (BinaryData::SliderClear_svg, BinaryData::SliderClear_svgSize)),
+      toggle (juce::Drawable::createFromImageData (BinaryData::rect833_png, BinaryData::rect833_pngSize))
+{
+    jassert (knob != nullptr && toggle != nullptr);
+
+    // The knob has always rotated about the middle of its component bounds
+    knobBounds = knob->getDrawableBounds();
+    knobCentre = { static_cast<float> (knob->getWidth() / 2), static_cast<float> (knob->getHeight() / 2) };
+}
+
+//==============================================================================
+const juce::Image& SkinCache::getKnobImage (float scale)
+{
+    auto& image = knobImages[getScaleKey (scale)];
+
+    if (image.isNull())
+    {
+        const auto area = (knobBounds * scale).getSmallestIntegerContainer();
+        image = juce::Image (juce::Image::ARGB, juce::jmax (1, area.getWidth()), juce::jmax (1, area.getHeight()), true);
+
+        juce::Graphics g (image);
+        knob->draw (g, 1.0f, juce::AffineTransform::translation (-knobBounds.getX(), -knobBounds.getY()).scaled (scale));
+    }
+
+    return image;
+}
+
+void SkinCache::drawKnob (juce::Graphics& g, float angleRadians)
+{
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto& image = getKnobImage (scale);
+
+    const juce::Graphics::ScopedSaveState state (g);
+    g.setImageResamplingQuality (juce::Graphics::highResamplingQuality);
+    g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / scale)
+                                       .translated (knobBounds.getX(), knobBounds.getY())
+                                       .rotated (angleRadians, knobCentre.x, knobCentre.y));
+}
+
+//==============================================================================
+const juce::Image& SkinCache::getToggleImage (juce::Rectangle<int> area, float scale)
+{
+    auto& image = toggleImages[std::make_tuple (area.getWidth(), area.getHeight(), getScaleKey (scale))];
+
+    if (image.isNull())
+    {
+        const auto width = juce::jmax (1, juce::roundToInt (area.getWidth() * scale));
+        const auto height = juce::jmax (1, juce::roundToInt (area.getHeight() * scale));
+        image = juce::Image (juce::Image::ARGB, width, height, true);
+
+        juce::Graphics g (image);
+        toggle->drawWithin (g, juce::Rectangle<float> ((float) width, (float) height), juce::RectanglePlacement::centred, 1.0f);
+    }
+
+    return image;
+}
+
+void SkinCache::drawToggle (juce::Graphics& g, juce::Rectangle<int> area, float opacity)
+{
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto& image = getToggleImage (area, scale);
+
+    const juce::Graphics::ScopedSaveState state (g);
+    g.setOpacity (opacity);
+    g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / scale).translated ((float) area.getX(), (float) area.getY()));
+}
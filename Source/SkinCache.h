@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    SkinCache.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    The editor's knob and toggle artwork, parsed once per process and rasterised once
+    per display scale.
+
+    Parsing the SVG/PNG and rendering its paths used to happen on every repaint of
+    every control. Now a repaint is a single image blit: the knob is rotated at blit
+    time from an image drawn at the display's physical resolution, and the toggle is
+    drawn at the exact size it's shown at.
+
+    Shared between every editor in the process through SharedResourcePointer. It's
+    only used from paint calls, so everything here runs on the message thread.
+*/
+class SkinCache
+{
+public:
+    SkinCache();
+
+    /** Draws the knob rotated by angleRadians about the centre of its artwork. */
+    void drawKnob (juce::Graphics& g, float angleRadians);
+
+    /** Draws the toggle artwork centred in area, at the given opacity. */
+    void drawToggle (juce::Graphics& g, juce::Rectangle<int> area, float opacity);
+
+private:
+    static int getScaleKey (float scale) noexcept    { return juce::roundToInt (scale * 100.0f); }
+
+    const juce::Image& getKnobImage (float scale);
+    const juce::Image& getToggleImage (juce::Rectangle<int> area, float scale);
+
+    std::unique_ptr<juce::Drawable> knob, toggle;
+    juce::Rectangle<float> knobBounds;
+    juce::Point<float> knobCentre;
+
+    // Keyed by scale (x100), and for the toggle by size too
+    std::map<int, juce::Image> knobImages;
+    std::map<std::tuple<int, int, int>, juce::Image> toggleImages;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SkinCache)
+};
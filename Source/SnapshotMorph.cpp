@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    SnapshotMorph.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "SnapshotMorph.h"
+
+SnapshotMorph::SnapshotMorph (juce::AudioProcessorValueTreeState& state, const juce::StringArray& excludedIDs)
+{
+    const auto& parameters = state.processor.getParameters();
+
+    numEntries = static_cast<size_t> (parameters.size());
+    entries.reset (new Entry[numEntries]);
+
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        auto& entry = entries[i];
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameters[(int) i]);
+
+        // Every parameter comes from the APVTS, so they're all ranged
+        jassert (ranged != nullptr);
+
+        entry.parameterID = ranged->paramID;
+        entry.parameter = ranged;
+        entry.rawValue = state.getRawParameterValue (ranged->paramID);
+        entry.value = entry.rawValue->load();
+        entry.morphs = ! excludedIDs.contains (ranged->paramID);
+        entry.discrete = ranged->isDiscrete() || ranged->isBoolean();
+    }
+
+    for (int slot = 0; slot < numSnapshots; ++slot)
+    {
+        snapshots[(size_t) slot].reset (new std::atomic<float>[numEntries]);
+        filled[(size_t) slot] = false;
+    }
+
+    position.reset (44100.0, 0.05);
+}
+
+std::atomic<float>* SnapshotMorph::getValue (const juce::String& parameterID) const noexcept
+{
+    for (size_t i = 0; i < numEntries; ++i)
+        if (entries[i].parameterID == parameterID)
+            return &entries[i].value;
+
+    jassertfalse;
+    return nullptr;
+}
+
+//==============================================================================
+void SnapshotMorph::prepare (double sampleRate) noexcept
+{
+    position.reset (sampleRate, 0.05);
+}
+
+float SnapshotMorph::getNormalisedValue (int slot, const Entry& entry, size_t index) const noexcept
+{
+    if (filled[(size_t) slot].load())
+        return snapshots[(size_t) slot][index].load();
+
+    return entry.parameter->convertTo0to1 (entry.rawValue->load());
+}
+
+void SnapshotMorph::process (float targetPosition, bool enabled, int numSamples) noexcept
+{
+    if (! enabled)
+    {
+        position.setCurrentAndTargetValue (targetPosition);
+
+        for (size_t i = 0; i < numEntries; ++i)
+            entries[i].value.store (entries[i].rawValue->load(), std::memory_order_relaxed);
+
+        return;
+    }
+
+    position.setTargetValue (targetPosition);
+    const auto current = position.skip (numSamples);
+
+    // Between snapshot `lower` and the one after it
+    const auto lower = juce::jlimit (0, numSnapshots - 2, static_cast<int> (current));
+    const auto proportion = juce::jlimit (0.0f, 1.0f, current - static_cast<float> (lower));
+
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        auto& entry = entries[i];
+
+        if (! entry.morphs)
+        {
+            entry.value.store (entry.rawValue->load(), std::memory_order_relaxed);
+            continue;
+        }
+
+        const auto from = getNormalisedValue (lower, entry, i);
+        const auto to = getNormalisedValue (lower + 1, entry, i);
+        const auto& range = entry.parameter->getNormalisableRange();
+
+        const auto value = entry.discrete ? range.snapToLegalValue (range.convertFrom0to1 (proportion < 0.5f ? from : to))
+                                          : range.convertFrom0to1 (from + proportion * (to - from));
+
+        entry.value.store (value, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+void SnapshotMorph::capture (int slot) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slot, numSnapshots));
+
+    for (size_t i = 0; i < numEntries; ++i)
+        snapshots[(size_t) slot][i] = entries[i].parameter->getValue();
+
+    filled[(size_t) slot] = true;
+}
+
+void SnapshotMorph::recall (int slot) noexcept
+{
+    if (! hasSnapshot (slot))
+        return;
+
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        auto* parameter = entries[i].parameter;
+        const auto value = snapshots[(size_t) slot][i].load();
+
+        // A gesture round each change, so hosts record it as a discrete edit when writing automation
+        if (entries[i].morphs && parameter->getValue() != value)
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost (value);
+            parameter->endChangeGesture();
+        }
+    }
+}
+
+void SnapshotMorph::clear (int slot) noexcept
+{
+    if (juce::isPositiveAndBelow (slot, numSnapshots))
+        filled[(size_t) slot] = false;
+}
+
+bool SnapshotMorph::hasSnapshot (int slot) const noexcept
+{
+    return juce::isPositiveAndBelow (slot, numSnapshots) && filled[(size_t) slot].load();
+}
+
+std::vector<float> SnapshotMorph::getSnapshotValues (int slot) const
+{
+    std::vector<float> values;
+
+    if (! hasSnapshot (slot))
+        return values;
+
+    values.reserve (numEntries);
+
+    for (size_t i = 0; i < numEntries; ++i)
+        values.push_back (entries[i].parameter->convertFrom0to1 (snapshots[(size_t) slot][i].load()));
+
+    return values;
+}
+
+void SnapshotMorph::setSnapshotValues (int slot, const std::vector<float>& values) noexcept
+{
+    if (! juce::isPositiveAndBelow (slot, numSnapshots))
+        return;
+
+    if (values.size() != numEntries)
+    {
+        clear (slot);
+        return;
+    }
+
+    for (size_t i = 0; i < numEntries; ++i)
+        snapshots[(size_t) slot][i] = entries[i].parameter->convertTo0to1 (values[i]);
+
+    filled[(size_t) slot] = true;
+}
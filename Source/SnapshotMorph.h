@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    SnapshotMorph.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Four parameter snapshots (A to D) and a morph across them.
+
+    Sits between the parameters and the DSP: the processor reads every parameter
+    through getValue(), which the audio thread refreshes once per sub-block. With
+    morphing off that's just the parameter's own value. With it on, the position
+    (0 = A, 1 = B, 2 = C, 3 = D) picks the two neighbouring snapshots, continuous
+    parameters are interpolated in their normalised range and discrete ones switch
+    halfway. The position itself is smoothed, and the DSP smooths the continuous
+    values further and crossfades mode changes, so sweeping the morph is click-free.
+
+    The parameters themselves aren't touched while morphing, so the host's
+    automation and the editor's controls stay where the user put them. An empty
+    slot stands in for the current parameter values.
+
+    Snapshots are stored as one atomic per parameter, written on the message thread
+    and read on the audio thread without locks.
+*/
+class SnapshotMorph
+{
+public:
+    static constexpr int numSnapshots = 4;
+
+    /** excludedIDs are passed straight through and never morphed, e.g. settings
+        that change the latency. */
+    SnapshotMorph (juce::AudioProcessorValueTreeState& state, const juce::StringArray& excludedIDs);
+
+    /** The value the DSP should use for a parameter, in the parameter's own range.
+        Stays valid for the lifetime of this object. */
+    std::atomic<float>* getValue (const juce::String& parameterID) const noexcept;
+
+    //==============================================================================
+    // Audio thread
+
+    void prepare (double sampleRate) noexcept;
+
+    /** Refreshes every value for the next numSamples samples. */
+    void process (float targetPosition, bool enabled, int numSamples) noexcept;
+
+    //==============================================================================
+    // Message thread
+
+    void capture (int slot) noexcept;
+    void recall (int slot) noexcept;
+    void clear (int slot) noexcept;
+    bool hasSnapshot (int slot) const noexcept;
+
+    /** A slot's values in each parameter's own range, in the processor's parameter
+        order. Empty if the slot is empty. Used to save and restore the state. */
+    std::vector<float> getSnapshotValues (int slot) const;
+    void setSnapshotValues (int slot, const std::vector<float>& values) noexcept;
+
+private:
+    struct Entry
+    {
+        juce::String parameterID;
+        juce::RangedAudioParameter* parameter = nullptr;
+        std::atomic<float>* rawValue = nullptr;
+        std::atomic<float> value { 0.0f };
+        bool morphs = false, discrete = false;
+    };
+
+    float getNormalisedValue (int slot, const Entry& entry, size_t index) const noexcept;
+
+    size_t numEntries = 0;
+    std::unique_ptr<Entry[]> entries;
+
+    // Normalised values, one array per slot
+    std::array<std::unique_ptr<std::atomic<float>[]>, numSnapshots> snapshots;
+    std::array<std::atomic<bool>, numSnapshots> filled {};
+
+    juce::SmoothedValue<float> position;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnapshotMorph)
+};
@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+    StateSerializer.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "StateSerializer.h"
+
+namespace
+{
+    constexpr int headerSize = 8;
+    constexpr int entrySize = 8;
+    constexpr int pointSize = 8;
+}
+
+StateSerializer::StateSerializer (juce::AudioProcessor& processorToSerialise)
+{
+    const auto& parameters = processorToSerialise.getParameters();
+
+    for (int i = 0; i < parameters.size(); ++i)
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameters[i]))
+            entries.push_back ({ hashParameterID (ranged->paramID), ranged, static_cast<size_t> (i) });
+
+    std::sort (entries.begin(), entries.end());
+    applied.resize (entries.size());
+
+    // Two IDs sharing a hash would load into each other, rename one of them
+    jassert (std::adjacent_find (entries.begin(), entries.end(),
+                                 [] (const Entry& a, const Entry& b) { return a.hash == b.hash; }) == entries.end());
+}
+
+juce::uint32 StateSerializer::hashParameterID (const juce::String& parameterID) noexcept
+{
+    // FNV-1a over the UTF-8 bytes. Unlike String::hashCode it's pinned down here, so saved
+    // blobs don't depend on the JUCE version.
+    juce::uint32 hash = 2166136261u;
+
+    for (auto* c = parameterID.toRawUTF8(); *c != 0; ++c)
+    {
+        hash ^= static_cast<juce::uint8> (*c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+//==============================================================================
+void StateSerializer::save (juce::MemoryBlock& destData, const Extras& extras) const
+{
+    const auto& customCurve = extras.customCurve;
+    const auto numPoints = juce::jmin (customCurve.size(), static_cast<size_t> (0xffff));
+    const auto numSnapshots = juce::jmin (extras.snapshots.size(), static_cast<size_t> (0xff));
+
+    destData.setSize (0);
+    destData.ensureSize (static_cast<size_t> (headerSize) + (numSnapshots + 1) * entries.size() * entrySize + numPoints * pointSize + 16);
+
+    juce::MemoryOutputStream output (destData, false);
+    output.writeInt (static_cast<int> (magic));
+    output.writeShort (static_cast<short> (currentVersion));
+    output.writeShort (static_cast<short> (entries.size()));
+
+    for (auto& entry : entries)
+    {
+        output.writeInt (static_cast<int> (entry.hash));
+        output.writeFloat (entry.parameter->convertFrom0to1 (entry.parameter->getValue()));
+    }
+
+    output.writeShort (static_cast<short> (numPoints));
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        output.writeFloat (customCurve[i].first);
+        output.writeFloat (customCurve[i].second);
+    }
+
+    output.writeByte (static_cast<char> (numSnapshots));
+
+    for (size_t slot = 0; slot < numSnapshots; ++slot)
+    {
+        const auto& values = extras.snapshots[slot];
+        const bool isFilled = ! values.empty();
+        output.writeShort (static_cast<short> (isFilled ? entries.size() : 0));
+
+        if (! isFilled)
+            continue;
+
+        for (auto& entry : entries)
+        {
+            output.writeInt (static_cast<int> (entry.hash));
+            output.writeFloat (entry.index < values.size() ? values[entry.index] : 0.0f);
+        }
+    }
+}
+
+juce::MemoryBlock StateSerializer::makeState (const std::vector<std::pair<juce::String, float>>& values)
+{
+    juce::MemoryBlock state;
+    juce::MemoryOutputStream output (state, false);
+
+    output.writeInt (static_cast<int> (magic));
+    output.writeShort (static_cast<short> (currentVersion));
+    output.writeShort (static_cast<short> (values.size()));
+
+    for (auto& value : values)
+    {
+        output.writeInt (static_cast<int> (hashParameterID (value.first)));
+        output.writeFloat (value.second);
+    }
+
+    // No curve, and no snapshot slots, so loading it leaves the snapshots alone
+    output.writeShort (0);
+    output.writeByte (0);
+    output.flush();
+    return state;
+}
+
+bool StateSerializer::load (const void* data, int sizeInBytes, Extras& extras)
+{
+    extras = {};
+
+    if (data == nullptr || sizeInBytes < headerSize)
+        return false;
+
+    juce::MemoryInputStream input (data, static_cast<size_t> (sizeInBytes), false);
+
+    if (static_cast<juce::uint32> (input.readInt()) == magic)
+        return loadBinary (input, extras);
+
+    return loadLegacyXml (data, sizeInBytes, extras);
+}
+
+bool StateSerializer::loadBinary (juce::MemoryInputStream& input, Extras& extras)
+{
+    const auto version = static_cast<juce::uint16> (input.readShort());
+    const auto numEntries = static_cast<juce::uint16> (input.readShort());
+
+    if (version == 0 || input.getNumBytesRemaining() < static_cast<juce::int64> (numEntries) * entrySize)
+        return false;
+
+    beginApplying();
+
+    for (int i = 0; i < numEntries; ++i)
+    {
+        const auto hash = static_cast<juce::uint32> (input.readInt());
+        apply (hash, input.readFloat());
+    }
+
+    finishApplying();
+
+    // Everything after the parameters is optional, a truncated curve is just ignored
+    if (input.getNumBytesRemaining() >= 2)
+    {
+        const auto numPoints = static_cast<juce::uint16> (input.readShort());
+
+        if (input.getNumBytesRemaining() >= static_cast<juce::int64> (numPoints) * pointSize)
+        {
+            extras.customCurve.resize (numPoints);
+
+            for (auto& point : extras.customCurve)
+            {
+                point.first = input.readFloat();
+                point.second = input.readFloat();
+            }
+
+            extras.hasCustomCurve = numPoints > 0;
+
+            if (version >= 2)
+                readSnapshots (input, extras);
+        }
+    }
+
+    return true;
+}
+
+void StateSerializer::readSnapshots (juce::MemoryInputStream& input, Extras& extras) const
+{
+    if (input.getNumBytesRemaining() < 1)
+        return;
+
+    const auto numSlots = static_cast<juce::uint8> (input.readByte());
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        if (input.getNumBytesRemaining() < 2)
+            break;
+
+        const auto numValues = static_cast<juce::uint16> (input.readShort());
+
+        if (input.getNumBytesRemaining() < static_cast<juce::int64> (numValues) * entrySize)
+            break;
+
+        ParameterValues values;
+
+        if (numValues > 0)
+        {
+            // Parameters the snapshot doesn't know about sit at their defaults
+            values.resize (entries.size());
+
+            for (auto& entry : entries)
+                values[entry.index] = entry.parameter->convertFrom0to1 (entry.parameter->getDefaultValue());
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                const auto hash = static_cast<juce::uint32> (input.readInt());
+                const auto value = input.readFloat();
+                const auto found = std::lower_bound (entries.begin(), entries.end(), Entry { hash, nullptr, 0 });
+
+                if (found != entries.end() && found->hash == hash)
+                    values[found->index] = value;
+            }
+        }
+
+        extras.snapshots.push_back (std::move (values));
+    }
+}
+
+bool StateSerializer::loadLegacyXml (const void* data, int sizeInBytes, Extras& extras)
+{
+    // Version 0: the APVTS state tree as XML, one PARAM child per parameter
+    std::unique_ptr<juce::XmlElement> xml (juce::AudioProcessor::getXmlFromBinary (data, sizeInBytes));
+
+    if (xml == nullptr || ! xml->hasTagName ("savedParams"))
+        return false;
+
+    beginApplying();
+
+    for (auto* child : xml->getChildWithTagNameIterator ("PARAM"))
+        apply (hashParameterID (child->getStringAttribute ("id")), static_cast<float> (child->getDoubleAttribute ("value")));
+
+    finishApplying();
+
+    if (xml->hasAttribute ("customCurve"))
+    {
+        extras.customCurve = curveFromString (xml->getStringAttribute ("customCurve"));
+        extras.hasCustomCurve = true;
+    }
+
+    return true;
+}
+
+//==============================================================================
+void StateSerializer::beginApplying() noexcept
+{
+    std::fill (applied.begin(), applied.end(), false);
+}
+
+void StateSerializer::apply (juce::uint32 hash, float value) noexcept
+{
+    const auto found = std::lower_bound (entries.begin(), entries.end(), Entry { hash, nullptr, 0 });
+
+    if (found == entries.end() || found->hash != hash)
+        return;
+
+    auto* parameter = found->parameter;
+    const auto normalised = parameter->convertTo0to1 (value);
+
+    // Unchanged values stay quiet, so hosts and attachments only hear about real changes
+    if (parameter->getValue() != normalised)
+        parameter->setValueNotifyingHost (normalised);
+
+    applied[(size_t) std::distance (entries.begin(), found)] = true;
+}
+
+void StateSerializer::finishApplying() noexcept
+{
+    // Anything the blob didn't mention was added after it was saved
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto* parameter = entries[i].parameter;
+
+        if (! applied[i] && parameter->getValue() != parameter->getDefaultValue())
+            parameter->setValueNotifyingHost (parameter->getDefaultValue());
+    }
+}
+
+//==============================================================================
+juce::String StateSerializer::curveToString (const CurvePoints& points)
+{
+    juce::StringArray pairs;
+
+    for (auto& point : points)
+        pairs.add (juce::String (point.first) + ":" + juce::String (point.second));
+
+    return pairs.joinIntoString (" ");
+}
+
+StateSerializer::CurvePoints StateSerializer::curveFromString (const juce::String& text)
+{
+    CurvePoints points;
+
+    for (auto& pair : juce::StringArray::fromTokens (text, " ", {}))
+        points.emplace_back (pair.upToFirstOccurrenceOf (":", false, false).getFloatValue(),
+                             pair.fromFirstOccurrenceOf (":", false, false).getFloatValue());
+
+    return points;
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    StateSerializer.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Reads and writes the plugin state as a small versioned binary blob.
+
+    Layout, little-endian throughout:
+
+        uint32  magic ('DZST')
+        uint16  format version
+        uint16  number of parameters
+        n *   { uint32 hash of the parameter ID, float32 value in the parameter's own range }
+        uint16  number of custom curve points
+        m *   { float32 input, float32 output }
+
+    Version 2 appends the morph snapshots:
+
+        uint8   number of snapshot slots
+        per slot: uint16 number of values, then that many { uint32 ID hash, float32 value }
+
+    Later versions may only append to this, so an older build still reads what it
+    understands from a newer blob.
+
+    Parameters are keyed by a hash of their ID, so adding, removing or reordering
+    parameters doesn't invalidate old blobs. An ID the processor doesn't know is
+    skipped, and a parameter the blob doesn't mention goes back to its default.
+
+    Loading never replaces the state tree. Every value goes through its parameter
+    object, the same way an APVTS state swap ends up doing it, so the audio thread
+    only ever sees whole parameter values. Values that haven't changed are skipped,
+    which keeps switching between similar presets quiet. Blobs saved by older
+    versions as XML are migrated on load.
+*/
+class StateSerializer
+{
+public:
+    using CurvePoints = std::vector<std::pair<float, float>>;
+
+    /** One value per parameter, in the processor's parameter order and each parameter's own range. */
+    using ParameterValues = std::vector<float>;
+
+    /** Everything in the state besides the parameters themselves. */
+    struct Extras
+    {
+        CurvePoints customCurve;
+        bool hasCustomCurve = false;
+
+        // One entry per snapshot slot the state carries, an empty one is an empty slot
+        std::vector<ParameterValues> snapshots;
+    };
+
+    static constexpr juce::uint32 magic = 0x54535a44;    // "DZST" once written little-endian
+    static constexpr int currentVersion = 2;
+
+    /** Indexes the processor's parameters. Call once they've all been added. */
+    explicit StateSerializer (juce::AudioProcessor& processorToSerialise);
+
+    void save (juce::MemoryBlock& destData, const Extras& extras) const;
+
+    /** Applies a blob from save(), or a legacy XML one, and fills in its extras. Returns
+        false and changes nothing if the data isn't a state this plugin wrote. */
+    bool load (const void* data, int sizeInBytes, Extras& extras);
+
+    /** A blob holding just the given parameter values, everything else at its default.
+        For presets defined in code. */
+    static juce::MemoryBlock makeState (const std::vector<std::pair<juce::String, float>>& values);
+
+    /** The custom curve as the state tree stores it, "input:output" pairs separated by spaces. */
+    static juce::String curveToString (const CurvePoints& points);
+    static CurvePoints curveFromString (const juce::String& text);
+
+private:
+    struct Entry
+    {
+        juce::uint32 hash;
+        juce::RangedAudioParameter* parameter;
+        size_t index;    // Position in the processor's parameter list
+
+        bool operator< (const Entry& other) const noexcept    { return hash < other.hash; }
+    };
+
+    static juce::uint32 hashParameterID (const juce::String& parameterID) noexcept;
+
+    bool loadBinary (juce::MemoryInputStream& input, Extras& extras);
+    bool loadLegacyXml (const void* data, int sizeInBytes, Extras& extras);
+    void readSnapshots (juce::MemoryInputStream& input, Extras& extras) const;
+
+    void beginApplying() noexcept;
+    void apply (juce::uint32 hash, float value) noexcept;
+    void finishApplying() noexcept;
+
+    // Sorted by hash, built once
+    std::vector<Entry> entries;
+    std::vector<bool> applied;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StateSerializer)
+};
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    Telemetry.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "Telemetry.h"
+
+const char* Telemetry::getStageName (Stage stage) noexcept
+{
+    switch (stage)
+    {
+        case Stage::upsample:      return "upsample";
+        case Stage::filters:       return "filters";
+        case Stage::dynamics:      return "dynamics";
+        case Stage::shaper:        return "shaper";
+        case Stage::downsample:    return "downsample";
+        case Stage::multiband:     return "multiband";
+        case Stage::numStages:     break;
+    }
+
+    return "";
+}
+
+//==============================================================================
+void Telemetry::beginBlock() noexcept
+{
+    currentStageTicks.fill (0);
+    blockStartTicks = now();
+}
+
+juce::int64 Telemetry::addStageTime (Stage stage, juce::int64 stageStartTicks) noexcept
+{
+    const auto ticks = now();
+    currentStageTicks[(size_t) stage] += ticks - stageStartTicks;
+    return ticks;
+}
+
+void Telemetry::endBlock (int numSamples, double sampleRate, int oversamplingFactor) noexcept
+{
+    const auto blockMs = static_cast<double> (now() - blockStartTicks) * ticksToMs();
+
+    if (resetRequested.exchange (false, std::memory_order_relaxed))
+        statistics = {};
+
+    // Averages are exponential over roughly the last hundred blocks, peaks hold until reset
+    constexpr double smoothing = 0.01;
+
+    auto average = [this] (double& value, double newValue)
+    {
+        value = statistics.numBlocks == 0 ? newValue : value + smoothing * (newValue - value);
+    };
+
+    const auto deadlineMs = sampleRate > 0.0 ? 1000.0 * numSamples / sampleRate : 0.0;
+    const auto load = deadlineMs > 0.0 ? blockMs / deadlineMs : 0.0;
+
+    average (statistics.averageBlockMs, blockMs);
+    average (statistics.averageLoad, load);
+
+    for (size_t stage = 0; stage < currentStageTicks.size(); ++stage)
+        average (statistics.averageStageMs[stage], static_cast<double> (currentStageTicks[stage]) * ticksToMs());
+
+    statistics.peakBlockMs = juce::jmax (statistics.peakBlockMs, blockMs);
+    statistics.peakLoad = juce::jmax (statistics.peakLoad, load);
+    statistics.oversamplingFactor = oversamplingFactor;
+    statistics.lastBlockSize = numSamples;
+    statistics.sampleRate = sampleRate;
+    ++statistics.numBlocks;
+
+    publish();
+}
+
+void Telemetry::publish() noexcept
+{
+    constexpr auto order = std::memory_order_relaxed;
+
+    published.numBlocks.store (statistics.numBlocks, order);
+    published.averageBlockMs.store (statistics.averageBlockMs, order);
+    published.peakBlockMs.store (statistics.peakBlockMs, order);
+
+    for (size_t stage = 0; stage < published.averageStageMs.size(); ++stage)
+        published.averageStageMs[stage].store (statistics.averageStageMs[stage], order);
+
+    published.averageLoad.store (statistics.averageLoad, order);
+    published.peakLoad.store (statistics.peakLoad, order);
+    published.oversamplingFactor.store (statistics.oversamplingFactor, order);
+    published.lastBlockSize.store (statistics.lastBlockSize, order);
+    published.sampleRate.store (statistics.sampleRate, order);
+}
+
+double Telemetry::ticksToMs() noexcept
+{
+    return 1000.0 / static_cast<double> (juce::Time::getHighResolutionTicksPerSecond());
+}
+
+//==============================================================================
+Telemetry::Snapshot Telemetry::getSnapshot() const noexcept
+{
+    constexpr auto order = std::memory_order_relaxed;
+    Snapshot snapshot;
+
+    if (resetRequested.load (order))
+        return snapshot;
+
+    snapshot.numBlocks = published.numBlocks.load (order);
+    snapshot.averageBlockMs = published.averageBlockMs.load (order);
+    snapshot.peakBlockMs = published.peakBlockMs.load (order);
+
+    for (size_t stage = 0; stage < snapshot.averageStageMs.size(); ++stage)
+        snapshot.averageStageMs[stage] = published.averageStageMs[stage].load (order);
+
+    snapshot.averageLoad = published.averageLoad.load (order);
+    snapshot.peakLoad = published.peakLoad.load (order);
+    snapshot.oversamplingFactor = published.oversamplingFactor.load (order);
+    snapshot.lastBlockSize = published.lastBlockSize.load (order);
+    snapshot.sampleRate = published.sampleRate.load (order);
+    return snapshot;
+}
+
+void Telemetry::resetStatistics() noexcept
+{
+    resetRequested.store (true, std::memory_order_relaxed);
+}
+
+juce::var Telemetry::toVar() const
+{
+    const auto snapshot = getSnapshot();
+
+    auto* stages = new juce::DynamicObject();
+
+    for (int stage = 0; stage < numStages; ++stage)
+        stages->setProperty (getStageName (static_cast<Stage> (stage)), snapshot.averageStageMs[(size_t) stage]);
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty ("blocks", snapshot.numBlocks);
+    object->setProperty ("average_block_ms", snapshot.averageBlockMs);
+    object->setProperty ("peak_block_ms", snapshot.peakBlockMs);
+    object->setProperty ("average_stage_ms", juce::var (stages));
+    object->setProperty ("average_load", snapshot.averageLoad);
+    object->setProperty ("peak_load", snapshot.peakLoad);
+    object->setProperty ("oversampling", snapshot.oversamplingFactor);
+    object->setProperty ("block_size", snapshot.lastBlockSize);
+    object->setProperty ("sample_rate", snapshot.sampleRate);
+    return juce::var (object);
+}
+
+juce::String Telemetry::toJson() const
+{
+    return juce::JSON::toString (toVar());
+}
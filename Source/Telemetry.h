@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Per-instance CPU counters for the processing chain.
+
+    The audio thread times each host block and each pipeline stage with the
+    high-resolution clock, and at the end of the block folds it straight into the
+    running statistics and publishes them through relaxed atomics, one per field. It
+    never waits, locks or allocates, and the statistics are current however long it's
+    been since anyone read them.
+
+    Readers (the editor's diagnostics overlay, the JSON dump) just load the published
+    fields. Every field is whole, though a snapshot taken mid-publish can mix two
+    neighbouring blocks, which is fine for diagnostics. A reset is asked for from any
+    thread and carried out by the audio thread at the end of its next block.
+*/
+class Telemetry
+{
+public:
+    enum class Stage
+    {
+        upsample = 0,
+        filters,        // Tone filters wherever FILTERPLACEMENT puts them
+        dynamics,       // tubeIsh's compressor at the host rate. Oversampled, it runs inside the shaper.
+        shaper,
+        downsample,
+        multiband,      // The whole band split, per-band chains and recombine
+        numStages
+    };
+
+    static constexpr int numStages = static_cast<int> (Stage::numStages);
+    static const char* getStageName (Stage stage) noexcept;
+
+    struct Snapshot
+    {
+        juce::int64 numBlocks = 0;
+
+        double averageBlockMs = 0.0;
+        double peakBlockMs = 0.0;
+        std::array<double, numStages> averageStageMs {};
+
+        // Processing time over the block's own duration. 1.0 means the block took as long
+        // to process as it takes to play, i.e. an xrun with nothing else running.
+        double averageLoad = 0.0;
+        double peakLoad = 0.0;
+
+        int oversamplingFactor = 1;
+        int lastBlockSize = 0;
+        double sampleRate = 0.0;
+    };
+
+    Telemetry() = default;
+
+    //==============================================================================
+    // Audio thread
+
+    static juce::int64 now() noexcept    { return juce::Time::getHighResolutionTicks(); }
+
+    void beginBlock() noexcept;
+
+    /** Adds the time since stageStartTicks to a stage. Returns the current time, so
+        consecutive stages can chain: start = addStageTime (Stage::upsample, start); */
+    juce::int64 addStageTime (Stage stage, juce::int64 stageStartTicks) noexcept;
+
+    void endBlock (int numSamples, double sampleRate, int oversamplingFactor) noexcept;
+
+    //==============================================================================
+    // Any other thread
+
+    /** The statistics as of the last block, or empty while a reset is still pending. */
+    Snapshot getSnapshot() const noexcept;
+    void resetStatistics() noexcept;
+
+    /** The snapshot as a JSON object, for profiling scripts. */
+    juce::var toVar() const;
+    juce::String toJson() const;
+
+private:
+    void publish() noexcept;
+    static double ticksToMs() noexcept;
+
+    // Audio thread only
+    juce::int64 blockStartTicks = 0;
+    std::array<juce::int64, numStages> currentStageTicks {};
+    Snapshot statistics;
+
+    // Written by the audio thread, read by anyone
+    struct Published
+    {
+        std::atomic<juce::int64> numBlocks { 0 };
+        std::atomic<double> averageBlockMs { 0.0 }, peakBlockMs { 0.0 };
+        std::array<std::atomic<double>, numStages> averageStageMs {};
+        std::atomic<double> averageLoad { 0.0 }, peakLoad { 0.0 };
+        std::atomic<int> oversamplingFactor { 1 }, lastBlockSize { 0 };
+        std::atomic<double> sampleRate { 0.0 };
+    };
+
+    Published published;
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Telemetry)
+};
@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+    Waveshaper.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "Waveshaper.h"
+
+Distortion::Mode Distortion::modeFromParameter (float distortionType) noexcept
+{
+    return static_cast<Mode> (juce::jlimit (static_cast<int> (Mode::hardClip),
+                                            static_cast<int> (Mode::tubeIsh),
+                                            juce::roundToInt (distortionType)));
+}
+
+float Distortion::shapeSample (Mode mode, float x) noexcept
+{
+    switch (mode)
+    {
+        case Mode::hardClip:    return Kernel<Mode::hardClip>::processSample (x);
+        case Mode::softClip:    return Kernel<Mode::softClip>::processSample (x);
+        case Mode::exponential: return Kernel<Mode::exponential>::processSample (x);
+        case Mode::arcTan:      return Kernel<Mode::arcTan>::processSample (x);
+        case Mode::tubeIsh:     return Kernel<Mode::tubeIsh>::processSample (x);
+        default:                break;
+    }
+
+    return x;
+}
+
+juce::StringArray Distortion::getAntialiasingNames()
+{
+    return { "Off", "ADAA 1st Order", "ADAA 2nd Order" };
+}
+
+juce::StringArray Distortion::getEngineNames()
+{
+    return { "Direct", "Table (Linear)", "Table (Cubic)", "Custom Curve" };
+}
+
+Distortion::ModeTables::ModeTables()
+{
+    tables[0].build (&Kernel<Mode::hardClip>::processSample);
+    tables[1].build (&Kernel<Mode::softClip>::processSample);
+    tables[2].build (&Kernel<Mode::exponential>::processSample);
+    tables[3].build (&Kernel<Mode::arcTan>::processSample);
+    tables[4].build (&Kernel<Mode::tubeIsh>::processSample);
+}
+
+//==============================================================================
+Waveshaper::Waveshaper()
+{
+    //Until a curve is loaded the custom engine behaves like hard clip
+    customTable.copyFrom ((*modeTables)[Distortion::Mode::hardClip]);
+
+    //tubeIsh's original voicing, until the caller sets its own
+    setDynamics (-4.0f, 4.0f, 10.0f, 50.0f);
+}
+
+void Waveshaper::setCustomCurve (const std::function<float (float)>& curve)
+{
+    CurveTable table;
+    table.build (curve);
+
+    const juce::SpinLock::ScopedLockType lock (customTableLock);
+    pendingCustomTable.copyFrom (table);
+    customTableChanged = true;
+}
+
+//==============================================================================
+void Waveshaper::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    dynamics.prepare (spec);
+
+    fadeBuffer.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+    antiderivativeStates.resize (spec.numChannels);
+    savedAntiderivativeStates.resize (spec.numChannels);
+    reset();
+}
+
+void Waveshaper::setDynamics (float thresholdDecibels, float ratio, float attackMs, float releaseMs) noexcept
+{
+    dynamics.setThreshold (thresholdDecibels);
+    dynamics.setRatio (ratio);
+    dynamics.setAttack (attackMs);
+    dynamics.setRelease (releaseMs);
+}
+
+void Waveshaper::reset()
+{
+    dynamics.reset();
+    std::fill (antiderivativeStates.begin(), antiderivativeStates.end(), ADAA::State());
+    currentMode = targetMode;
+}
+
+void Waveshaper::saveState (State& state) const
+{
+    state.antiderivativeStates = antiderivativeStates;
+    dynamics.saveState (state.dynamics);
+    state.currentMode = currentMode;
+}
+
+void Waveshaper::restoreState (const State& state) noexcept
+{
+    jassert (state.antiderivativeStates.size() == antiderivativeStates.size());
+    std::copy (state.antiderivativeStates.begin(), state.antiderivativeStates.end(), antiderivativeStates.begin());
+    dynamics.restoreState (state.dynamics);
+    currentMode = state.currentMode;
+}
+
+float Waveshaper::getGainReductionDecibels() const noexcept
+{
+    if (currentMode != Distortion::Mode::tubeIsh || ! useInternalDynamics)
+        return 0.0f;
+
+    return dynamics.getGainReductionDecibels();
+}
+
+float Waveshaper::getLatencyInSamples() const noexcept
+{
+    // The same cases processKernel shapes some other way
+    if (engine == Distortion::Engine::customCurve || targetMode == Distortion::Mode::softClip)
+        return 0.0f;
+
+    return static_cast<float> (antialiasing) * 0.5f;
+}
+
+void Waveshaper::process (const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    {
+        // If the message thread is mid-update, the new curve just arrives a block later
+        const juce::SpinLock::ScopedTryLockType lock (customTableLock);
+
+        if (lock.isLocked() && customTableChanged)
+        {
+            customTable.copyFrom (pendingCustomTable);
+            customTableChanged = false;
+        }
+    }
+
+    auto block = context.getOutputBlock();
+
+    if (targetMode == currentMode)
+    {
+        processMode (currentMode, block);
+        return;
+    }
+
+    // Render the outgoing mode into the fade buffer, the incoming mode in place,
+    // then ramp from one to the other across this block
+    auto numChannels = block.getNumChannels();
+    auto numSamples = block.getNumSamples();
+    jassert (numChannels <= static_cast<size_t> (fadeBuffer.getNumChannels())
+             && numSamples <= static_cast<size_t> (fadeBuffer.getNumSamples()));
+
+    auto fadeBlock = juce::dsp::AudioBlock<float> (fadeBuffer).getSubBlock (0, numSamples)
+                                                              .getSubsetChannelBlock (0, numChannels);
+    fadeBlock.copyFrom (block);
+
+    std::copy (antiderivativeStates.begin(), antiderivativeStates.end(), savedAntiderivativeStates.begin());
+    processMode (currentMode, fadeBlock);
+    std::copy (savedAntiderivativeStates.begin(), savedAntiderivativeStates.end(), antiderivativeStates.begin());
+    processMode (targetMode, block);
+
+    const auto step = 1.0f / static_cast<float> (juce::jmax (static_cast<size_t> (1), numSamples));
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* out = block.getChannelPointer (channel);
+        const auto* old = fadeBlock.getChannelPointer (channel);
+
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            const auto gain = static_cast<float> (sample) * step;
+            out[sample] = old[sample] + gain * (out[sample] - old[sample]);
+        }
+    }
+
+    currentMode = targetMode;
+}
+
+void Waveshaper::processMode (Distortion::Mode mode, juce::dsp::AudioBlock<float>& block)
+{
+    using Distortion::Mode;
+
+    switch (mode)
+    {
+        case Mode::hardClip:    processKernel<Mode::hardClip> (block);    break;
+        case Mode::softClip:    processKernel<Mode::softClip> (block);    break;
+        case Mode::exponential: processKernel<Mode::exponential> (block); break;
+        case Mode::arcTan:      processKernel<Mode::arcTan> (block);      break;
+        case Mode::tubeIsh:     processKernel<Mode::tubeIsh> (block);     break;
+        default:                jassertfalse;                             break;
+    }
+}
+
+// Modes without a closed form antiderivative fall through to the plain kernel
+template <>
+bool Waveshaper::processAntiderivative<void> (juce::dsp::AudioBlock<float>&)
+{
+    return false;
+}
+
+template <Distortion::Mode mode>
+void Waveshaper::processKernel (juce::dsp::AudioBlock<float>& block)
+{
+    if (driveRamp != nullptr)
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::multiply (block.getChannelPointer (channel), driveRamp, static_cast<int> (block.getNumSamples()));
+    }
+    else
+    {
+        block.multiplyBy (drive);
+    }
+
+    if (mode == Distortion::Mode::tubeIsh && useInternalDynamics)
+        dynamics.process (block);
+
+    using Distortion::Engine;
+
+    if (engine != Engine::customCurve && antialiasing != Distortion::Antialiasing::off
+         && processAntiderivative<typename Distortion::Kernel<mode>::Antiderivative> (block))
+        return;
+
+    //Whatever shapes the block instead, the ADAA history follows the input so antialiasing
+    //comes back in from where the signal actually is
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        antiderivativeStates[channel].skip (block.getChannelPointer (channel), block.getNumSamples());
+
+    if (engine == Engine::customCurve)
+    {
+        processTable (customTable, CurveTable::Interpolation::cubic, block);
+        return;
+    }
+
+    //Exact output skips the tables along with the FastMath approximations
+    if (useFastApproximations && (engine == Engine::tableLinear || engine == Engine::tableCubic))
+    {
+        processTable ((*modeTables)[mode],
+                      engine == Engine::tableLinear ? CurveTable::Interpolation::linear : CurveTable::Interpolation::cubic,
+                      block);
+        return;
+    }
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer (channel);
+
+        if (useFastApproximations)
+        {
+            FastMath::apply (data, block.getNumSamples(), [] (auto x) { return Distortion::Kernel<mode>::processSampleFast (x); });
+        }
+        else
+        {
+            for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+                data[sample] = Distortion::Kernel<mode>::processSample (data[sample]);
+        }
+    }
+}
+
+void Waveshaper::processTable (const CurveTable& table, CurveTable::Interpolation interpolation, juce::dsp::AudioBlock<float>& block) const
+{
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer (channel);
+
+        if (interpolation == CurveTable::Interpolation::linear)
+            table.process<CurveTable::Interpolation::linear> (data, block.getNumSamples());
+        else
+            table.process<CurveTable::Interpolation::cubic> (data, block.getNumSamples());
+    }
+}
+
+template <typename Curve>
+bool Waveshaper::processAntiderivative (juce::dsp::AudioBlock<float>& block)
+{
+    jassert (block.getNumChannels() <= antiderivativeStates.size());
+
+    const auto order = antialiasing == Distortion::Antialiasing::firstOrder ? 1 : 2;
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer (channel);
+        auto& state = antiderivativeStates[channel];
+
+        //Rebuilds the cached antiderivatives if the last block used another curve or order
+        state.prepare<Curve> (order);
+
+        if (order == 1)
+        {
+            for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+                data[sample] = ADAA::processFirstOrder<Curve> (static_cast<double> (data[sample]), state);
+        }
+        else
+        {
+            for (size_t sample = 0; sample < block.getNumSamples(); ++sample)
+                data[sample] = ADAA::processSecondOrder<Curve> (static_cast<double> (data[sample]), state);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    Waveshaper.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include "Antiderivatives.h"
+#include "CurveTable.h"
+#include "DynamicsStage.h"
+
+namespace Distortion
+{
+    // Matches the values of the DISTORTIONTYPE parameter
+    enum class Mode
+    {
+        hardClip = 1,
+        softClip,
+        exponential,
+        arcTan,
+        tubeIsh
+    };
+
+    Mode modeFromParameter (float distortionType) noexcept;
+
+    /** The mode's exact curve for a single sample, for drawing it. Not for the audio path. */
+    float shapeSample (Mode mode, float x) noexcept;
+
+    // Matches the indices of the ANTIALIASING parameter
+    enum class Antialiasing
+    {
+        off = 0,
+        firstOrder,
+        secondOrder
+    };
+
+    juce::StringArray getAntialiasingNames();
+
+    // Matches the indices of the SHAPERENGINE parameter
+    enum class Engine
+    {
+        direct = 0,
+        tableLinear,
+        tableCubic,
+        customCurve
+    };
+
+    juce::StringArray getEngineNames();
+
+    //==============================================================================
+    // One transfer curve per mode. Every kernel is branch-free so the per-block loop
+    // in Waveshaper compiles down to a straight run of arithmetic for the chosen mode.
+    // processSample is the exact reference. processSampleFast is the same curve on the
+    // FastMath operations and approximations, a template over float and FastMath::Vec so
+    // FastMath::apply runs it four samples at a time.
+    // Antiderivative names the ADAA curve for the mode, or void if it has none.
+    template <Mode mode>
+    struct Kernel;
+
+    template <>
+    struct Kernel<Mode::hardClip>
+    {
+        using Antiderivative = ADAA::HardClip;
+
+        static float processSample (float x) noexcept
+        {
+            return juce::jlimit (-1.0f, 1.0f, x);
+        }
+
+        template <typename Value>
+        static Value processSampleFast (Value x) noexcept
+        {
+            return FastMath::max (Value (-1.0f), FastMath::min (x, Value (1.0f)));
+        }
+    };
+
+    template <>
+    struct Kernel<Mode::softClip>
+    {
+        using Antiderivative = void;
+
+        // Quadratic soft clip: linear (2x) below 1/3, quadratic knee up to 2/3, flat above
+        static float processSample (float x) noexcept
+        {
+            const auto a = juce::jmin (std::abs (x), 2.0f / 3.0f);
+            const auto knee = (2.0f - 3.0f * a);
+            const auto y = a > 1.0f / 3.0f ? (3.0f - knee * knee) / 3.0f : 2.0f * a;
+            return std::copysign (y, x);
+        }
+
+        template <typename Value>
+        static Value processSampleFast (Value x) noexcept
+        {
+            const Value a = FastMath::min (FastMath::abs (x), Value (2.0f / 3.0f));
+            const Value knee = Value (2.0f) - Value (3.0f) * a;
+            const Value y = FastMath::select (FastMath::greaterThan (a, Value (1.0f / 3.0f)),
+                                              (Value (3.0f) - knee * knee) / Value (3.0f), Value (2.0f) * a);
+            return FastMath::copySign (y, x);
+        }
+    };
+
+    template <>
+    struct Kernel<Mode::exponential>
+    {
+        using Antiderivative = ADAA::Exponential;
+
+        static float processSample (float x) noexcept
+        {
+            return std::copysign (1.5f * (1.0f - std::exp (-std::abs (x))), x);
+        }
+
+        template <typename Value>
+        static Value processSampleFast (Value x) noexcept
+        {
+            return FastMath::copySign (Value (1.5f) * (Value (1.0f) - FastMath::expMinusAbs (x)), x);
+        }
+    };
+
+    template <>
+    struct Kernel<Mode::arcTan>
+    {
+        using Antiderivative = ADAA::ArcTan;
+
+        static float processSample (float x) noexcept
+        {
+            return (2.0f / juce::MathConstants<float>::pi) * std::atan (x);
+        }
+
+        template <typename Value>
+        static Value processSampleFast (Value x) noexcept
+        {
+            return Value (2.0f / juce::MathConstants<float>::pi) * FastMath::atan (x);
+        }
+    };
+
+    template <>
+    struct Kernel<Mode::tubeIsh>
+    {
+        // ADAA uses the tanh this curve approximates, its antiderivative has a closed form
+        using Antiderivative = ADAA::Tanh;
+
+        // Rational tanh-like curve. The dynamics stage that feeds it lives in Waveshaper.
+        static float processSample (float x) noexcept
+        {
+            x *= 0.25f;
+            const auto a = std::abs (x);
+            const auto x2 = x * x;
+            const auto y = 1.0f - 1.0f / (1.0f + a + x2 + 0.66422417311781f * x2 * a + 0.36483285408241f * x2 * x2);
+            return std::copysign (3.0f * y, x);
+        }
+
+        // The same arithmetic as processSample, on the FastMath operations
+        template <typename Value>
+        static Value processSampleFast (Value x) noexcept
+        {
+            x = x * Value (0.25f);
+            const Value a = FastMath::abs (x);
+            const Value x2 = x * x;
+            const Value y = Value (1.0f) - Value (1.0f) / (Value (1.0f) + a + x2 + Value (0.66422417311781f) * x2 * a
+                                                           + Value (0.36483285408241f) * x2 * x2);
+            return FastMath::copySign (Value (3.0f) * y, x);
+        }
+    };
+
+    //==============================================================================
+    /** Every mode's curve as a CurveTable, for the table engines. The curves never change,
+        so all the shapers in the process share one set through juce::SharedResourcePointer. */
+    struct ModeTables
+    {
+        ModeTables();
+
+        const CurveTable& operator[] (Mode mode) const noexcept    { return tables[static_cast<size_t> (mode) - 1]; }
+
+        std::array<CurveTable, 5> tables;
+    };
+}
+
+//==============================================================================
+/**
+    Applies drive and the selected distortion curve to a whole block at a time.
+
+    The mode is resolved once per block and dispatched to a dedicated loop for that
+    kernel. When the mode changes, the block is rendered through both the old and the
+    new kernel and crossfaded so the switch doesn't click.
+
+    With antialiasing on, every mode except softClip is shaped through its first or
+    second order antiderivative instead, which keeps aliasing down at 1x or 2x
+    oversampling for a fraction of the cost of running at 8x or 16x.
+
+    The table engines read each mode's curve from tables shared by every shaper in the
+    process, and the custom curve engine reads a user supplied curve in place of the mode's.
+*/
+class Waveshaper
+{
+public:
+    Waveshaper();
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void setMode (Distortion::Mode newMode) noexcept    { targetMode = newMode; }
+    void setDrive (float newDrive) noexcept             { drive = newDrive; driveRamp = nullptr; }
+
+    /** Uses a per-sample drive for the next process() call. The ramp must cover the whole block. */
+    void setDriveRamp (const float* newDriveRamp) noexcept    { driveRamp = newDriveRamp; }
+
+    /** Compensates the dynamics' time constants when they run at a lower rate than they
+        were prepared for, so the oversampling factor can change without re-preparing. */
+    void setRateScale (float preparedRateOverActualRate) noexcept    { dynamics.setRateScale (preparedRateOverActualRate); }
+
+    /** Sets up the compression tubeIsh mode applies before its curve. Only recalculates
+        what changed, so it's cheap to call every block. */
+    void setDynamics (float thresholdDecibels, float ratio, float attackMs, float releaseMs) noexcept;
+
+    /** Links the dynamics' channels, see DynamicsStage::setChannelGroups. */
+    void setChannelGroups (const std::vector<int>& groups) noexcept    { dynamics.setChannelGroups (groups); }
+
+    /** tubeIsh's gain reduction over the last block, 0 in any other mode or while the
+        caller runs the dynamics itself. */
+    float getGainReductionDecibels() const noexcept;
+
+    /** Turn off to leave tubeIsh's compression to the caller, e.g. when it runs at the host rate. */
+    void setUseInternalDynamics (bool shouldUseInternalDynamics) noexcept    { useInternalDynamics = shouldUseInternalDynamics; }
+
+    /** Chooses between the FastMath path, four samples at a time, and the exact scalar std:: path. */
+    void setUseFastApproximations (bool shouldUseFast) noexcept
+    {
+        useFastApproximations = shouldUseFast;
+        dynamics.setUseFastApproximations (shouldUseFast);
+    }
+
+    void setAntialiasing (Distortion::Antialiasing newAntialiasing) noexcept    { antialiasing = newAntialiasing; }
+
+    void setEngine (Distortion::Engine newEngine) noexcept    { engine = newEngine; }
+
+    /** Tabulates a curve for the customCurve engine. Call from the message thread, the
+        audio thread picks the new table up at the start of its next block. */
+    void setCustomCurve (const std::function<float (float)>& curve);
+
+    /** The delay the antialiasing adds, in samples at the rate the shaper runs at:
+        half a sample for first order, one sample for second order. softClip and the
+        customCurve engine skip ADAA, so they add none. Follows the mode and engine
+        last set, so check it again after changing either. */
+    float getLatencyInSamples() const noexcept;
+
+    void process (const juce::dsp::ProcessContextReplacing<float>& context);
+
+    /** The ADAA history, the dynamics and where a mode crossfade is up to, for running the
+        shaper twice over the same stretch of time, see FilterStage::State. */
+    struct State
+    {
+        std::vector<ADAA::State> antiderivativeStates;
+        DynamicsStage::State dynamics;
+        Distortion::Mode currentMode = Distortion::Mode::hardClip;
+    };
+
+    /** The first save into a State allocates, so do that from prepareToPlay. */
+    void saveState (State& state) const;
+    void restoreState (const State& state) noexcept;
+
+private:
+    void processMode (Distortion::Mode mode, juce::dsp::AudioBlock<float>& block);
+
+    template <Distortion::Mode mode>
+    void processKernel (juce::dsp::AudioBlock<float>& block);
+
+    void processTable (const CurveTable& table, CurveTable::Interpolation interpolation, juce::dsp::AudioBlock<float>& block) const;
+
+    /** Shapes the block through Curve's antiderivatives, returns false if the mode has none. */
+    template <typename Curve>
+    bool processAntiderivative (juce::dsp::AudioBlock<float>& block);
+
+    Distortion::Mode currentMode = Distortion::Mode::hardClip;
+    Distortion::Mode targetMode = Distortion::Mode::hardClip;
+    float drive = 1.0f;
+    const float* driveRamp = nullptr;
+    bool useFastApproximations = true;
+    Distortion::Antialiasing antialiasing = Distortion::Antialiasing::off;
+    Distortion::Engine engine = Distortion::Engine::direct;
+
+    juce::SharedResourcePointer<Distortion::ModeTables> modeTables;
+
+    // The custom curve is built into the pending table off the audio thread and copied
+    // across under the lock
+    CurveTable customTable, pendingCustomTable;
+    juce::SpinLock customTableLock;
+    bool customTableChanged = false;
+
+    // Per-channel ADAA history. The saved copy lets both modes of a crossfade start
+    // from the same history, each rebuilding the cached antiderivatives for its own curve.
+    std::vector<ADAA::State> antiderivativeStates, savedAntiderivativeStates;
+
+    // tubeIsh mode compresses the driven signal before it hits the curve
+    DynamicsStage dynamics;
+    bool useInternalDynamics = true;
+
+    // Holds the outgoing mode's render while crossfading
+    juce::AudioBuffer<float> fadeBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Waveshaper)
+};
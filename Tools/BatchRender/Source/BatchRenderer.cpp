@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+
+namespace
+{
+    const juce::String inputWildcard ("*.wav;*.flac");
+
+    juce::String formatSeconds (double seconds)
+    {
+        return juce::String (seconds, 2) + " s";
+    }
+}
+
+//==============================================================================
+/** A pool job that owns one processor and keeps taking files until there are none left. */
+class BatchRenderer::Worker : public juce::ThreadPoolJob
+{
+public:
+    explicit Worker (BatchRenderer& rendererToUse)
+        : juce::ThreadPoolJob ("deetzStortion batch render worker"),
+          renderer (rendererToUse)
+    {
+        formats.registerBasicFormats();
+
+        // Before the state, so the state never reaches a realtime-quality path
+        processor.setNonRealtime (true);
+
+        const auto& state = renderer.settings.state;
+
+        if (state.getSize() > 0)
+            processor.setStateInformation (state.getData(), static_cast<int> (state.getSize()));
+
+        // Whatever the state says, a batch render is a bounce
+        if (auto* offlineQuality = processor.apvts.getParameter ("OFFLINEQUALITY"))
+            offlineQuality->setValueNotifyingHost (1.0f);
+    }
+
+    JobStatus runJob() override
+    {
+        for (;;)
+        {
+            const auto index = renderer.nextInput++;
+
+            if (shouldExit() || index >= static_cast<int> (renderer.results.size()))
+                return jobHasFinished;
+
+            auto& result = renderer.results[(size_t) index];
+
+            if (result.succeeded())
+                result = renderer.renderFile (processor, formats, result.input);
+
+            renderer.report (result, *renderer.progressStream);
+        }
+    }
+
+private:
+    BatchRenderer& renderer;
+    DeetzStortionAPVTSAudioProcessor processor;
+    juce::AudioFormatManager formats;
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer (const Settings& settingsToUse)
+    : settings (settingsToUse),
+      pool (juce::jmax (1, settingsToUse.numWorkers))
+{
+    settings.numWorkers = juce::jmax (1, settings.numWorkers);
+    settings.blockSize = juce::jmax (1, settings.blockSize);
+
+    // Processors are built here rather than on the pool's threads, as their parameters
+    // and state expect the message thread
+    for (int i = 0; i < settings.numWorkers; ++i)
+        workers.add (new Worker (*this));
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    pool.removeAllJobs (true, -1);
+}
+
+juce::Array<juce::File> BatchRenderer::findInputFiles (const juce::StringArray& paths, const juce::File& workingDirectory)
+{
+    juce::Array<juce::File> files;
+
+    for (auto& path : paths)
+    {
+        const auto file = workingDirectory.getChildFile (path);
+
+        if (file.isDirectory())
+        {
+            auto found = file.findChildFiles (juce::File::findFiles, true, inputWildcard);
+            std::sort (found.begin(), found.end(), [] (const juce::File& a, const juce::File& b)
+            {
+                return a.getFullPathName().compareNatural (b.getFullPathName()) < 0;
+            });
+
+            files.addArray (found);
+        }
+        else
+        {
+            // Missing files are kept, so they're reported as failures rather than silently dropped
+            files.add (file);
+        }
+    }
+
+    return files;
+}
+
+juce::File BatchRenderer::getOutputFile (const juce::File& input) const
+{
+    const auto extension = settings.outputFormat.isNotEmpty() ? "." + settings.outputFormat.toLowerCase()
+                                                              : input.getFileExtension().toLowerCase();
+
+    return settings.outputDirectory.getChildFile (input.getFileNameWithoutExtension() + extension);
+}
+
+//==============================================================================
+int BatchRenderer::render (const juce::Array<juce::File>& inputsToRender, std::ostream& progress)
+{
+    progressStream = &progress;
+    nextInput = 0;
+    results.assign ((size_t) inputsToRender.size(), {});
+
+    // Two inputs with the same name would render to the same file, so neither is rendered
+    std::map<juce::File, int> outputCounts;
+
+    for (auto& input : inputsToRender)
+        ++outputCounts[getOutputFile (input)];
+
+    for (int i = 0; i < inputsToRender.size(); ++i)
+    {
+        auto& result = results[(size_t) i];
+        result.input = inputsToRender.getReference (i);
+        result.output = getOutputFile (result.input);
+
+        if (outputCounts[result.output] > 1)
+            result.error = "another input has the same name, so they'd both render to " + result.output.getFullPathName();
+    }
+
+    if (! settings.outputDirectory.createDirectory())
+    {
+        progress << "Couldn't create " << settings.outputDirectory.getFullPathName() << std::endl;
+        return inputsToRender.size();
+    }
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    // No more workers than files, the rest would only start and finish straight away
+    const auto numWorkers = juce::jmin (workers.size(), inputsToRender.size());
+
+    for (int i = 0; i < numWorkers; ++i)
+        pool.addJob (workers[i], false);
+
+    for (int i = 0; i < numWorkers; ++i)
+        pool.waitForJobToFinish (workers[i], -1);
+
+    const auto wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    int numFailures = 0;
+    double audioSeconds = 0.0;
+
+    for (auto& result : results)
+    {
+        if (result.succeeded())
+            audioSeconds += result.audioSeconds;
+        else
+            ++numFailures;
+    }
+
+    progress << "Rendered " << (inputsToRender.size() - numFailures) << " of " << inputsToRender.size() << " files: "
+             << formatSeconds (audioSeconds) << " of audio in " << formatSeconds (wallSeconds) << ", "
+             << juce::String (wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, 1) << "x realtime across "
+             << numWorkers << (numWorkers == 1 ? " worker" : " workers") << std::endl;
+
+    progressStream = nullptr;
+    return numFailures;
+}
+
+void BatchRenderer::report (const Result& result, std::ostream& progress)
+{
+    const juce::ScopedLock scopedLock (progressLock);
+
+    if (result.succeeded())
+        progress << juce::String (result.getRealtimeMultiple(), 1) << "x realtime  " << result.input.getFullPathName()
+                 << " -> " << result.output.getFullPathName() << " (" << formatSeconds (result.audioSeconds)
+                 << " in " << formatSeconds (result.renderSeconds) << ")" << std::endl;
+    else
+        progress << "FAILED  " << result.input.getFullPathName() << ": " << result.error << std::endl;
+}
+
+//==============================================================================
+BatchRenderer::Result BatchRenderer::renderFile (DeetzStortionAPVTSAudioProcessor& processor,
+                                                 juce::AudioFormatManager& formats, const juce::File& input) const
+{
+    Result result;
+    result.input = input;
+    result.output = getOutputFile (input);
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    if (result.output == input)
+    {
+        result.error = "the output would overwrite the input, pick another output directory";
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+    if (reader == nullptr)
+    {
+        result.error = input.existsAsFile() ? "not a readable WAV or FLAC file" : "no such file";
+        return result;
+    }
+
+    auto* format = formats.findFormatForFileExtension (result.output.getFileExtension());
+
+    if (format == nullptr)
+    {
+        result.error = "can't write " + result.output.getFileExtension() + " files";
+        return result;
+    }
+
+    const auto numChannels = static_cast<int> (reader->numChannels);
+    const auto sampleRate = reader->sampleRate;
+    const auto length = reader->lengthInSamples;
+
+    auto bitDepth = settings.bitDepth > 0 ? settings.bitDepth : static_cast<int> (reader->bitsPerSample);
+
+    if (! format->getPossibleBitDepths().contains (bitDepth))
+        bitDepth = 24;
+
+    // Written next to the target and only moved over it once complete
+    juce::TemporaryFile temporary (result.output);
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    {
+        std::unique_ptr<juce::FileOutputStream> stream (temporary.getFile().createOutputStream());
+
+        if (stream != nullptr)
+            writer.reset (format->createWriterFor (stream.get(), sampleRate, static_cast<unsigned int> (numChannels),
+                                                   bitDepth, reader->metadataValues, 0));
+
+        if (writer == nullptr)
+        {
+            result.error = "couldn't open " + result.output.getFullPathName() + " for writing as "
+                         + juce::String (bitDepth) + "-bit " + format->getFormatName();
+            return result;
+        }
+
+        // The writer owns the stream now
+        stream.release();
+    }
+
+    const auto blockSize = settings.blockSize;
+    processor.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    // The latency is fixed for the whole render, the oversampling settings don't change
+    const auto latency = static_cast<juce::int64> (processor.getLatencySamples());
+    const auto numSamplesToProcess = length + latency;
+
+    juce::AudioBuffer<float> buffer (numChannels, blockSize);
+    juce::MidiBuffer midi;
+    bool writeFailed = false;
+
+    for (juce::int64 position = 0; position < numSamplesToProcess && ! writeFailed; position += blockSize)
+    {
+        const auto numSamples = static_cast<int> (juce::jmin (static_cast<juce::int64> (blockSize), numSamplesToProcess - position));
+        buffer.setSize (numChannels, numSamples, false, false, true);
+
+        // Past the end of the file this reads silence, which flushes the latency back out
+        reader->read (&buffer, 0, numSamples, position, true, true);
+        processor.processBlock (buffer, midi);
+
+        // The first `latency` samples out are the processor's delay, not the input
+        const auto skip = static_cast<int> (juce::jlimit (static_cast<juce::int64> (0), static_cast<juce::int64> (numSamples), latency - position));
+
+        if (skip < numSamples)
+            writeFailed = ! writer->writeFromAudioSampleBuffer (buffer, skip, numSamples - skip);
+    }
+
+    processor.releaseResources();
+    writer.reset();
+
+    if (writeFailed)
+        result.error = "writing " + result.output.getFullPathName() + " failed";
+    else if (! temporary.overwriteTargetFileWithTemporary())
+        result.error = "couldn't replace " + result.output.getFullPathName();
+
+    result.audioSeconds = static_cast<double> (length) / sampleRate;
+    result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    return result;
+}
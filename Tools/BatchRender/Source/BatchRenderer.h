@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+/**
+    Streams audio files through DeetzStortionAPVTSAudioProcessor, headlessly and as
+    fast as the machine allows.
+
+    Files are shared out across a thread pool. Each worker owns its own processor,
+    all loaded with the same state, and takes the next file whenever it finishes one,
+    so long and short files balance out on their own. A file is read, processed and
+    written in large blocks, so memory use doesn't grow with the file length. The
+    processor already splits whatever it's given into its own sub-blocks.
+
+    The processors run non-realtime with OFFLINEQUALITY forced on, so they render
+    exactly like a DAW bounce: maximum oversampling, linear phase filters and exact
+    maths. The processor's latency is trimmed off the front and rendered out at the
+    end, so every output lines up with its input sample for sample. That keeps
+    stems in sync.
+
+    Outputs go to a temporary file that only replaces the target once the render
+    has succeeded. A failed or interrupted file never leaves a half-written stem
+    behind.
+*/
+class BatchRenderer
+{
+public:
+    struct Settings
+    {
+        juce::MemoryBlock state;        // A saved state or preset, empty renders at the defaults
+        juce::File outputDirectory;
+        juce::String outputFormat;      // "wav" or "flac", empty keeps each input's format
+        int bitDepth = 0;               // 0 keeps each input's bit depth where the format allows
+        int blockSize = 65536;
+        int numWorkers = juce::SystemStats::getNumCpus();
+    };
+
+    struct Result
+    {
+        juce::File input, output;
+        juce::String error;             // Empty if the file rendered
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;     // Wall time, reading and writing included
+
+        bool succeeded() const noexcept    { return error.isEmpty(); }
+        double getRealtimeMultiple() const noexcept    { return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0; }
+    };
+
+    /** Builds and loads every worker's processor. Call from the message thread. */
+    explicit BatchRenderer (const Settings& settings);
+    ~BatchRenderer();
+
+    /** Renders every input and blocks until they're all done. One line per file goes
+        to progress as it finishes, followed by the totals. Returns the number of
+        files that failed. */
+    int render (const juce::Array<juce::File>& inputsToRender, std::ostream& progress);
+
+    /** Expands directories (recursively) into the audio files they hold. */
+    static juce::Array<juce::File> findInputFiles (const juce::StringArray& paths, const juce::File& workingDirectory);
+
+private:
+    class Worker;
+
+    Result renderFile (DeetzStortionAPVTSAudioProcessor& processor, juce::AudioFormatManager& formats, const juce::File& input) const;
+    juce::File getOutputFile (const juce::File& input) const;
+    void report (const Result& result, std::ostream& progress);
+
+    Settings settings;
+    juce::OwnedArray<Worker> workers;
+    juce::ThreadPool pool;
+
+    // Shared with the workers for the length of a render() call
+    std::vector<Result> results;
+    std::atomic<int> nextInput { 0 };
+    std::ostream* progressStream = nullptr;
+    juce::CriticalSection progressLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchRenderer)
+};
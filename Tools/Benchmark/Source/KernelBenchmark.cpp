@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+    Microbenchmark for the shaping and output stages. Runs every distortion mode
+    through the original per-sample loop and through the Waveshaper/OutputStage
+    path, and prints cycles per oversampled sample for each. The dry/wet mix now
+    happens at the host rate in a DryWetMixer, so the new path only pays for the
+    shaper and output gain here. The table column runs the same path through the
+    cubic lookup table engine.
+
+  ==============================================================================
+*/
+
+#include "KernelBenchmark.h"
+#include "../../../Source/Waveshaper.h"
+#include "../../../Source/OutputStage.h"
+
+namespace
+{
+    constexpr int numChannels = 2;
+    constexpr int blockSize = 512 * 4;    // A 512 sample host block at 4x oversampling
+    constexpr int numBlocks = 2000;
+
+    constexpr float drive = 6.0f;
+    constexpr float dryWet = 80.0f;
+    constexpr float volume = -3.0f;
+
+    //==============================================================================
+    // The shaping and output loop as it was before the Waveshaper, kept as the baseline
+    struct LegacyShaper
+    {
+        void prepare (const juce::dsp::ProcessSpec& spec)
+        {
+            compressor.prepare (spec);
+            compressor.setAttack (10.0f);
+            compressor.setRelease (50.0f);
+            compressor.setRatio (4.0f);
+            compressor.setThreshold (-4.0f);
+        }
+
+        void process (juce::dsp::AudioBlock<float>& block, float distortionType)
+        {
+            for (int channel = 0; channel < (int) block.getNumChannels(); channel++) {
+                for (int sample = 0; sample < (int) block.getNumSamples(); sample++) {
+                    float in = block.getSample (channel, sample);
+                    float cleanSig = in;
+
+                    if (distortionType == 1 || distortionType == 2 || distortionType == 3 || distortionType == 4 || distortionType == 5)
+                        in *= drive;
+
+                    float out = 0.0f;
+                    if (distortionType == 1) {
+                        out = in > 1.0f ? 1.0f : (in < -1.0f ? -1.0f : in);
+                    }
+                    else if (distortionType == 2) {
+                        float threshold1 = 1.0f / 3.0f;
+                        float threshold2 = 2.0f / 3.0f;
+                        if (in > threshold2)
+                            out = 1.0f;
+                        else if (in > threshold1)
+                            out = (3.0f - (2.0f - 3.0f * in) * (2.0f - 3.0f * in)) / 3.0f;
+                        else if (in < -threshold2)
+                            out = -1.0f;
+                        else if (in < -threshold1)
+                            out = -(3.0f - (2.0f + 3.0f * in) * (2.0f + 3.0f * in)) / 3.0f;
+                        else
+                            out = 2.0f * in;
+                    }
+                    else if (distortionType == 3) {
+                        out = in > 0 ? 1.0f - expf (-in) : -1.0f + expf (in);
+                        out = out * 1.5f;
+                    }
+                    else if (distortionType == 4) {
+                        out = (2.0f / juce::MathConstants<float>::pi) * std::atan (in);
+                    }
+                    else if (distortionType == 5) {
+                        out = compressor.processSample (channel, in);
+                        float x = out * 0.25f;
+                        float a = std::abs (x);
+                        float x2 = x * x;
+                        float y = 1 - 1 / (1 + a + x2 + 0.66422417311781f * x2 * a + 0.36483285408241f * x2 * x2);
+                        out = (x >= 0 ? y : -y) * 3.0f;
+                    }
+
+                    out = (((out * (dryWet / 100.0f)) + (cleanSig * (1.0f - (dryWet / 100.0f)))) * juce::Decibels::decibelsToGain (volume));
+                    out /= (float) std::pow (drive, 0.65);
+                    block.setSample (channel, sample, out);
+                }
+            }
+        }
+
+        juce::dsp::Compressor<float> compressor;
+    };
+
+    //==============================================================================
+    template <typename ProcessFunction>
+    double measureCyclesPerSample (juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& work, ProcessFunction&& process)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            work.makeCopyOf (source, true);
+            juce::dsp::AudioBlock<float> block (work);
+            process (block);
+        }
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+        const auto nanosecondsPerSample = seconds * 1.0e9 / ((double) numBlocks * blockSize * numChannels);
+
+        return nanosecondsPerSample * juce::SystemStats::getCpuSpeedInMegahertz() / 1000.0;
+    }
+}
+
+//==============================================================================
+void runKernelBenchmark (std::ostream& output)
+{
+    juce::dsp::ProcessSpec spec { 44100.0 * 4, (juce::uint32) blockSize, (juce::uint32) numChannels };
+
+    juce::AudioBuffer<float> source (numChannels, blockSize), work (numChannels, blockSize);
+    juce::Random random (0x5eed);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int i = 0; i < blockSize; ++i)
+            source.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+    output << "mode,legacy_cycles_per_sample,new_cycles_per_sample,speedup,table_cycles_per_sample" << std::endl;
+
+    for (int mode = 1; mode <= 5; ++mode)
+    {
+        LegacyShaper legacy;
+        legacy.prepare (spec);
+
+        Waveshaper waveshaper;
+        waveshaper.prepare (spec);
+        waveshaper.setRateScale (1.0f);
+        waveshaper.setMode (Distortion::modeFromParameter ((float) mode));
+        waveshaper.setDrive (drive);
+
+        OutputStage outputStage;
+        outputStage.setGain (juce::Decibels::decibelsToGain (volume) * OutputStage::getMakeupGain (drive));
+
+        const auto before = measureCyclesPerSample (source, work, [&] (juce::dsp::AudioBlock<float>& block)
+        {
+            legacy.process (block, (float) mode);
+        });
+
+        const auto after = measureCyclesPerSample (source, work, [&] (juce::dsp::AudioBlock<float>& block)
+        {
+            waveshaper.process (juce::dsp::ProcessContextReplacing<float> (block));
+            outputStage.process (block);
+        });
+
+        waveshaper.setEngine (Distortion::Engine::tableCubic);
+
+        const auto table = measureCyclesPerSample (source, work, [&] (juce::dsp::AudioBlock<float>& block)
+        {
+            waveshaper.process (juce::dsp::ProcessContextReplacing<float> (block));
+            outputStage.process (block);
+        });
+
+        output << mode << "," << before << "," << after << "," << before / after << "," << table << std::endl;
+    }
+}
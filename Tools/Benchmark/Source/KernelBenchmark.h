@@ -0,0 +1,16 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Times the original per-sample shaping loop against the Waveshaper path, per mode, as CSV. */
+void runKernelBenchmark (std::ostream& output);
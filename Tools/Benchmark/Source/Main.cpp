@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Headless benchmark for DeetzStortionAPVTS. Usage:
+
+        DeetzStortionBenchmark [--kernels]
+                               [--seconds <audio seconds per case>]
+                               [--rates 44100,48000] [--blocks 64,512] [--channels 1,2]
+                               [--oversampling 1,2,4,8,16] [--modes 1,2,3,4,5]
+                               [--format csv|json] [--output <file>]
+                               [--baseline <previous csv>] [--tolerance 0.15]
+
+    Exits with 1 if any case is slower than the baseline by more than the tolerance.
+
+    Regression checks (each exits with 1 on any failure):
+
+        DeetzStortionBenchmark --render-references <dir>
+        DeetzStortionBenchmark --verify <dir> [--null-tolerance -80]
+        DeetzStortionBenchmark --verify-baseline [--null-tolerance -80]
+        DeetzStortionBenchmark --aliasing
+        DeetzStortionBenchmark --accuracy
+        DeetzStortionBenchmark --adaa-switching
+        DeetzStortionBenchmark --oversampling-switching
+        DeetzStortionBenchmark --block-sizes [--null-tolerance -120]
+        DeetzStortionBenchmark --realtime-safety    (Debug builds, which define DEETZ_REALTIME_SAFETY_CHECKS)
+        DeetzStortionBenchmark --state-recall
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "KernelBenchmark.h"
+#include "ProcessorBenchmark.h"
+#include "RegressionSuite.h"
+
+namespace
+{
+    juce::String getOption (const juce::StringArray& args, const juce::String& name, const juce::String& defaultValue = {})
+    {
+        const auto index = args.indexOf (name);
+        return index >= 0 && index + 1 < args.size() ? args[index + 1] : defaultValue;
+    }
+
+    template <typename ValueType>
+    void parseList (const juce::StringArray& args, const juce::String& name, juce::Array<ValueType>& values)
+    {
+        const auto option = getOption (args, name);
+
+        if (option.isEmpty())
+            return;
+
+        values.clear();
+
+        for (auto& token : juce::StringArray::fromTokens (option, ",", {}))
+            values.add (static_cast<ValueType> (token.getDoubleValue()));
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The processor's parameter state needs a message manager, but nothing is ever shown
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::StringArray args (argv + 1, argc - 1);
+
+    if (args.contains ("--kernels"))
+    {
+        runKernelBenchmark (std::cout);
+        return 0;
+    }
+
+    const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    if (args.contains ("--render-references"))
+        return RegressionSuite::renderReferences (workingDirectory.getChildFile (getOption (args, "--render-references")), std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--verify"))
+        return RegressionSuite::verify (workingDirectory.getChildFile (getOption (args, "--verify")),
+                                        getOption (args, "--null-tolerance", "-80").getDoubleValue(), std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--verify-baseline"))
+        return RegressionSuite::verifyAgainstBaseline (getOption (args, "--null-tolerance", "-80").getDoubleValue(), std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--aliasing"))
+        return RegressionSuite::measureAliasing (std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--accuracy"))
+        return RegressionSuite::checkKernelAccuracy (std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--adaa-switching"))
+        return RegressionSuite::checkAntialiasingSwitches (std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--oversampling-switching"))
+        return RegressionSuite::checkOversamplingSwitches (std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--block-sizes"))
+        return RegressionSuite::checkBlockSizeIndependence (getOption (args, "--null-tolerance", "-120").getDoubleValue(), std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--realtime-safety"))
+        return RegressionSuite::checkRealtimeSafety (std::cout) > 0 ? 1 : 0;
+
+    if (args.contains ("--state-recall"))
+        return RegressionSuite::checkStateRecall (std::cout) > 0 ? 1 : 0;
+
+    ProcessorBenchmark::Matrix matrix;
+    parseList (args, "--rates", matrix.sampleRates);
+    parseList (args, "--blocks", matrix.blockSizes);
+    parseList (args, "--channels", matrix.channelCounts);
+    parseList (args, "--modes", matrix.distortionTypes);
+
+    juce::Array<int> factors;
+    parseList (args, "--oversampling", factors);
+
+    if (! factors.isEmpty())
+    {
+        matrix.oversamplingIndices.clear();
+
+        for (auto factor : factors)
+            matrix.oversamplingIndices.add (juce::roundToInt (std::log2 ((double) juce::jmax (1, factor))));
+    }
+
+    ProcessorBenchmark benchmark (getOption (args, "--seconds", "1.0").getDoubleValue());
+    const auto results = benchmark.run (matrix, std::cerr);
+
+    std::ostringstream formatted;
+
+    if (getOption (args, "--format", "csv") == "json")
+        ProcessorBenchmark::writeJson (results, formatted);
+    else
+        ProcessorBenchmark::writeCsv (results, formatted);
+
+    const auto outputPath = getOption (args, "--output");
+
+    if (outputPath.isNotEmpty())
+        workingDirectory.getChildFile (outputPath).replaceWithText (formatted.str());
+    else
+        std::cout << formatted.str();
+
+    const auto baselinePath = getOption (args, "--baseline");
+
+    if (baselinePath.isNotEmpty())
+    {
+        const auto baselineFile = workingDirectory.getChildFile (baselinePath);
+        const auto tolerance = getOption (args, "--tolerance", "0.15").getDoubleValue();
+
+        if (ProcessorBenchmark::compareWithBaseline (results, baselineFile, tolerance, std::cerr) > 0)
+            return 1;
+    }
+
+    return 0;
+}
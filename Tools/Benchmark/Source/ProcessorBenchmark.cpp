@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    ProcessorBenchmark.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "ProcessorBenchmark.h"
+#include "ProcessorHelpers.h"
+
+namespace
+{
+    constexpr int warmupBlocks = 16;
+}
+
+//==============================================================================
+juce::String ProcessorBenchmark::Case::getKey() const
+{
+    return juce::String (juce::roundToInt (sampleRate)) + "," + juce::String (blockSize) + ","
+         + juce::String (numChannels) + "," + juce::String (1 << oversamplingIndex) + "x,"
+         + juce::String (distortionType);
+}
+
+ProcessorBenchmark::ProcessorBenchmark (double secondsOfAudio)
+    : secondsOfAudioPerCase (secondsOfAudio)
+{
+}
+
+juce::Array<ProcessorBenchmark::Result> ProcessorBenchmark::run (const Matrix& matrix, std::ostream& progress)
+{
+    juce::Array<Result> results;
+
+    for (auto sampleRate : matrix.sampleRates)
+        for (auto blockSize : matrix.blockSizes)
+            for (auto numChannels : matrix.channelCounts)
+                for (auto oversamplingIndex : matrix.oversamplingIndices)
+                    for (auto distortionType : matrix.distortionTypes)
+                    {
+                        const Case config { sampleRate, blockSize, numChannels, oversamplingIndex, distortionType };
+                        results.add (runCase (config));
+                        progress << "." << std::flush;
+                    }
+
+    progress << std::endl;
+    return results;
+}
+
+ProcessorBenchmark::Result ProcessorBenchmark::runCase (const Case& config)
+{
+    DeetzStortionAPVTSAudioProcessor processor;
+
+    using ProcessorHelpers::setParameter;
+    setParameter (processor, "OVERSAMPLING", (float) config.oversamplingIndex);
+    setParameter (processor, "DISTORTIONTYPE", (float) config.distortionType);
+    setParameter (processor, "DRIVE", 6.0f);
+    setParameter (processor, "DRYWET", 80.0f);
+    setParameter (processor, "HIGHPASSCUTOFF", 80.0f);
+    setParameter (processor, "LOWPASSCUTOFF", 12000.0f);
+
+    processor.setPlayConfigDetails (config.numChannels, config.numChannels, config.sampleRate, config.blockSize);
+    processor.prepareToPlay (config.sampleRate, config.blockSize);
+
+    juce::AudioBuffer<float> source (config.numChannels, config.blockSize);
+    juce::AudioBuffer<float> buffer (config.numChannels, config.blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random (0x5eed);
+    // -6dBFS white noise, loud enough that the silence detector never kicks in
+    ProcessorHelpers::fillWithNoise (source, random, 0.5f);
+
+    for (int i = 0; i < warmupBlocks; ++i)
+    {
+        buffer.makeCopyOf (source, true);
+        processor.processBlock (buffer, midi);
+    }
+
+    const auto numBlocks = juce::jmax (1, juce::roundToInt (secondsOfAudioPerCase * config.sampleRate / config.blockSize));
+    juce::int64 processingTicks = 0;
+    auto& telemetry = processor.getTelemetry();
+    telemetry.resetStatistics();
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        buffer.makeCopyOf (source, true);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        processor.processBlock (buffer, midi);
+        processingTicks += juce::Time::getHighResolutionTicks() - startTicks;
+    }
+
+    processor.releaseResources();
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds (processingTicks);
+    const auto numSamples = (double) numBlocks * config.blockSize;
+
+    Result result;
+    result.config = config;
+    result.nanosecondsPerSample = seconds * 1.0e9 / (numSamples * config.numChannels);
+    result.realtimeFactor = (numSamples / config.sampleRate) / seconds;
+    result.telemetry = telemetry.toVar();
+    return result;
+}
+
+//==============================================================================
+void ProcessorBenchmark::writeCsv (const juce::Array<Result>& results, std::ostream& output)
+{
+    output << "sample_rate,block_size,channels,oversampling,mode,ns_per_sample,realtime_factor" << std::endl;
+
+    for (auto& result : results)
+        output << result.config.getKey() << "," << result.nanosecondsPerSample << "," << result.realtimeFactor << std::endl;
+}
+
+void ProcessorBenchmark::writeJson (const juce::Array<Result>& results, std::ostream& output)
+{
+    juce::Array<juce::var> cases;
+
+    for (auto& result : results)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty ("sample_rate", result.config.sampleRate);
+        object->setProperty ("block_size", result.config.blockSize);
+        object->setProperty ("channels", result.config.numChannels);
+        object->setProperty ("oversampling", 1 << result.config.oversamplingIndex);
+        object->setProperty ("mode", result.config.distortionType);
+        object->setProperty ("ns_per_sample", result.nanosecondsPerSample);
+        object->setProperty ("realtime_factor", result.realtimeFactor);
+        object->setProperty ("telemetry", result.telemetry);
+        cases.add (juce::var (object));
+    }
+
+    output << juce::JSON::toString (juce::var (cases)) << std::endl;
+}
+
+int ProcessorBenchmark::compareWithBaseline (const juce::Array<Result>& results, const juce::File& baselineCsv,
+                                             double tolerance, std::ostream& report)
+{
+    juce::StringArray lines;
+    baselineCsv.readLines (lines);
+
+    // Key is everything up to the ns_per_sample column
+    std::map<juce::String, double> baseline;
+
+    for (int i = 1; i < lines.size(); ++i)
+    {
+        auto columns = juce::StringArray::fromTokens (lines[i], ",", {});
+
+        if (columns.size() >= 7)
+            baseline[columns[0] + "," + columns[1] + "," + columns[2] + "," + columns[3] + "," + columns[4]] = columns[5].getDoubleValue();
+    }
+
+    int numRegressions = 0;
+
+    for (auto& result : results)
+    {
+        auto found = baseline.find (result.config.getKey());
+
+        if (found == baseline.end() || found->second <= 0.0)
+            continue;
+
+        const auto change = result.nanosecondsPerSample / found->second - 1.0;
+
+        if (change > tolerance)
+        {
+            report << "REGRESSION " << result.config.getKey() << ": " << found->second << " -> "
+                   << result.nanosecondsPerSample << " ns/sample (+" << juce::roundToInt (change * 100.0) << "%)" << std::endl;
+            ++numRegressions;
+        }
+    }
+
+    return numRegressions;
+}
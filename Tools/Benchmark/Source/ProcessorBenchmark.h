@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    ProcessorBenchmark.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Runs DeetzStortionAPVTSAudioProcessor headlessly (no editor) across a matrix of
+    sample rates, block sizes, channel counts, oversampling factors and distortion
+    modes, and reports ns/sample and realtime factor for each case.
+
+    Results can be written as CSV or JSON and compared against a previous CSV run,
+    flagging any case that got slower by more than the tolerance. The JSON also carries
+    each case's per-stage breakdown from the processor's telemetry.
+*/
+class ProcessorBenchmark
+{
+public:
+    struct Case
+    {
+        double sampleRate;
+        int blockSize;
+        int numChannels;
+        int oversamplingIndex;     // Index of the OVERSAMPLING choice, 0 = 1x ... 4 = 16x
+        int distortionType;        // DISTORTIONTYPE, 1..5
+
+        juce::String getKey() const;
+    };
+
+    struct Result
+    {
+        Case config;
+        double nanosecondsPerSample;    // Per channel, per host-rate sample
+        double realtimeFactor;          // Seconds of audio processed per second of CPU
+        juce::var telemetry;            // The processor's own per-stage counters, see Telemetry::toVar
+    };
+
+    struct Matrix
+    {
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0 };
+        juce::Array<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048 };
+        juce::Array<int> channelCounts { 1, 2 };
+        juce::Array<int> oversamplingIndices { 0, 1, 2, 3, 4 };
+        juce::Array<int> distortionTypes { 1, 2, 3, 4, 5 };
+    };
+
+    explicit ProcessorBenchmark (double secondsOfAudioPerCase = 1.0);
+
+    juce::Array<Result> run (const Matrix& matrix, std::ostream& progress);
+    Result runCase (const Case& config);
+
+    static void writeCsv (const juce::Array<Result>& results, std::ostream& output);
+    static void writeJson (const juce::Array<Result>& results, std::ostream& output);
+
+    /** Compares against a CSV written by writeCsv. Returns the number of regressions found. */
+    static int compareWithBaseline (const juce::Array<Result>& results, const juce::File& baselineCsv,
+                                    double tolerance, std::ostream& report);
+
+private:
+    double secondsOfAudioPerCase;
+};
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    ProcessorHelpers.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+namespace ProcessorHelpers
+{
+    /** Sets a parameter by ID in its real (not normalised) range. */
+    inline void setParameter (DeetzStortionAPVTSAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = processor.apvts.getParameter (parameterID))
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    /** Fills a buffer with white noise at the given peak gain. */
+    inline void fillWithNoise (juce::AudioBuffer<float>& buffer, juce::Random& random, float gain)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * gain;
+        }
+    }
+
+    /** Runs a whole buffer through the processor in host-sized blocks. */
+    inline void render (DeetzStortionAPVTSAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int blockSize)
+    {
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < buffer.getNumSamples(); start += blockSize)
+        {
+            const auto length = juce::jmin (blockSize, buffer.getNumSamples() - start);
+            juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, length);
+            processor.processBlock (block, midi);
+        }
+    }
+}
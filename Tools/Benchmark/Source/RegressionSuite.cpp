@@ -0,0 +1,978 @@
+/*
+  ==============================================================================
+
+    RegressionSuite.cpp
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#include "RegressionSuite.h"
+#include "ProcessorHelpers.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr int blockSize = 512;
+    constexpr int renderLength = 48000;
+
+    struct TestSignal
+    {
+        juce::String name;
+        std::function<float (int)> generate;
+    };
+
+    struct ParameterSet
+    {
+        juce::String name;
+        float drive, dryWet, highPassCutoff, lowPassCutoff;
+        bool makeupGain;
+    };
+
+    juce::Array<TestSignal> getTestSignals()
+    {
+        constexpr auto twoPi = juce::MathConstants<double>::twoPi;
+
+        return {
+            { "sine1k",  [] (int i) { return 0.5f * (float) std::sin (twoPi * 1000.0 * i / sampleRate); } },
+            { "sine5k",  [] (int i) { return 0.5f * (float) std::sin (twoPi * 5000.0 * i / sampleRate); } },
+            { "sweep",   [] (int i)
+                         {
+                             // Log sweep 20Hz to 20kHz over the whole render
+                             const auto duration = renderLength / sampleRate;
+                             const auto ratio = std::log (20000.0 / 20.0);
+                             const auto t = i / sampleRate;
+                             return 0.5f * (float) std::sin (twoPi * 20.0 * duration / ratio * (std::exp (t / duration * ratio) - 1.0));
+                         } },
+            { "impulse", [] (int i) { return i == 0 ? 1.0f : 0.0f; } },
+            { "noise",   [] (int i) { return (float) (((juce::uint32) i * 1664525u + 1013904223u) >> 8) / 8388608.0f - 1.0f; } }
+        };
+    }
+
+    juce::Array<ParameterSet> getParameterSets()
+    {
+        return {
+            { "clean",    1.0f,  100.0f, 20.0f, 20000.0f, false },
+            { "driven",   8.0f,  100.0f, 80.0f, 12000.0f, false },
+            { "parallel", 15.0f, 50.0f,  20.0f, 20000.0f, true }
+        };
+    }
+
+    std::unique_ptr<DeetzStortionAPVTSAudioProcessor> createProcessor (const ParameterSet& parameters, int distortionType,
+                                                                       int oversamplingIndex, int antialiasing)
+    {
+        using ProcessorHelpers::setParameter;
+
+        auto processor = std::make_unique<DeetzStortionAPVTSAudioProcessor>();
+        setParameter (*processor, "OVERSAMPLING", (float) oversamplingIndex);
+        setParameter (*processor, "OVERSAMPLINGFILTER", 0.0f);
+        setParameter (*processor, "ANTIALIASING", (float) antialiasing);
+        setParameter (*processor, "DISTORTIONTYPE", (float) distortionType);
+        setParameter (*processor, "DRIVE", parameters.drive);
+        setParameter (*processor, "DRYWET", parameters.dryWet);
+        setParameter (*processor, "HIGHPASSCUTOFF", parameters.highPassCutoff);
+        setParameter (*processor, "LOWPASSCUTOFF", parameters.lowPassCutoff);
+        setParameter (*processor, "AUTOMAKEUPGAIN", parameters.makeupGain ? 1.0f : 0.0f);
+        setParameter (*processor, "VOLUME", 0.0f);
+
+        processor->setNonRealtime (false);
+        processor->setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+        processor->prepareToPlay (sampleRate, blockSize);
+        return processor;
+    }
+
+    juce::AudioBuffer<float> render (const TestSignal& signal, const ParameterSet& parameters, int distortionType,
+                                     int oversamplingIndex = 2, int antialiasing = 0)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, renderLength);
+
+        for (int i = 0; i < renderLength; ++i)
+        {
+            const auto sample = signal.generate (i);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.setSample (channel, i, sample);
+        }
+
+        auto processor = createProcessor (parameters, distortionType, oversamplingIndex, antialiasing);
+        ProcessorHelpers::render (*processor, buffer, blockSize);
+        return buffer;
+    }
+
+    template <typename Callback>
+    void forEachCase (Callback&& callback)
+    {
+        for (auto& signal : getTestSignals())
+            for (auto& parameters : getParameterSets())
+                for (int distortionType = 1; distortionType <= 5; ++distortionType)
+                    callback (signal.name + "_" + parameters.name + "_mode" + juce::String (distortionType) + ".wav",
+                              render (signal, parameters, distortionType));
+    }
+
+    //==============================================================================
+    /** The original release's curves (fd9fcac), kept exactly as its processBlock wrote them.
+        tubeIsh's compressor runs ahead of this, see renderBaseline. */
+    float shapeBaselineSample (int distortionType, float in)
+    {
+        switch (distortionType)
+        {
+            case 1:  return in > 1.0f ? 1.0f : (in < -1.0f ? -1.0f : in);
+            case 2:  return in > 2.0f / 3.0f  ? 1.0f
+                          : in > 1.0f / 3.0f  ? (3.0f - (2.0f - 3.0f * in) * (2.0f - 3.0f * in)) / 3.0f
+                          : in < -2.0f / 3.0f ? -1.0f
+                          : in < -1.0f / 3.0f ? -(3.0f - (2.0f + 3.0f * in) * (2.0f + 3.0f * in)) / 3.0f
+                          : 2.0f * in;
+            case 3:  return (in > 0 ? 1.0f - std::exp (-in) : -1.0f + std::exp (in)) * 1.5f;
+            case 4:  return (float) (2.0 / juce::MathConstants<double>::pi * std::atan ((double) in));
+            case 5:
+            {
+                const float x = in * 0.25f;
+                const float a = std::abs (x);
+                const float x2 = x * x;
+                const float y = (float) (1 - 1 / (1 + a + x2 + 0.66422417311781 * x2 * a + 0.36483285408241 * x2 * x2));
+                return (x >= 0 ? y : -y) * 3.0f;
+            }
+            default: jassertfalse; return in;
+        }
+    }
+
+    /** Renders a signal through the original release's chain, frozen here so there's always
+        a reference to null against: 4x IIR oversampling, the TPT highpass then lowpass, and
+        the per-sample shaping, volume and makeup loop, with tubeIsh's juce::dsp::Compressor
+        (which DynamicsStage reproduces) ahead of its curve. Where the rewrite changed the
+        chain on purpose, this follows the rewrite:
+        - a filter at the end of its range (20Hz highpass, 20kHz lowpass) is skipped
+        - the dry signal is mixed in at the host rate, unfiltered and delayed by the
+          oversampler's latency, rather than inside the oversampled loop */
+    juce::AudioBuffer<float> renderBaseline (const TestSignal& signal, const ParameterSet& parameters, int distortionType)
+    {
+        constexpr int factor = 4;
+
+        juce::dsp::Oversampling<float> oversampling ((size_t) numChannels, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, false);
+        oversampling.initProcessing ((size_t) blockSize);
+
+        const juce::dsp::ProcessSpec baseSpec { sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels };
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> dryDelay (2048);
+        dryDelay.prepare (baseSpec);
+        dryDelay.setDelay (oversampling.getLatencyInSamples());
+
+        const juce::dsp::ProcessSpec spec { sampleRate * factor, (juce::uint32) (blockSize * factor), (juce::uint32) numChannels };
+        juce::dsp::StateVariableTPTFilter<float> highPass, lowPass;
+        highPass.prepare (spec);
+        lowPass.prepare (spec);
+        highPass.setType (juce::dsp::StateVariableTPTFilterType::highpass);
+        lowPass.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+        highPass.setCutoffFrequency (parameters.highPassCutoff);
+        lowPass.setCutoffFrequency (parameters.lowPassCutoff);
+
+        const auto useHighPass = parameters.highPassCutoff > 20.0f;
+        const auto useLowPass = parameters.lowPassCutoff < 20000.0f;
+
+        // The original's fixed tubeIsh settings, which are still the COMP parameters' defaults
+        juce::dsp::Compressor<float> compressor;
+        compressor.prepare (spec);
+        compressor.setThreshold (-4.0f);
+        compressor.setRatio (4.0f);
+        compressor.setAttack (10.0f);
+        compressor.setRelease (50.0f);
+
+        const auto mix = parameters.dryWet / 100.0f;
+        const auto makeupGain = parameters.makeupGain ? std::pow (parameters.drive, 0.65f) : 1.0f;
+
+        juce::AudioBuffer<float> buffer (numChannels, renderLength), dry (numChannels, blockSize);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < renderLength; ++i)
+                buffer.setSample (channel, i, signal.generate (i));
+
+        for (int start = 0; start < renderLength; start += blockSize)
+        {
+            auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) juce::jmin (blockSize, renderLength - start));
+            auto dryBlock = juce::dsp::AudioBlock<float> (dry).getSubBlock (0, block.getNumSamples());
+            dryBlock.copyFrom (block);
+            dryDelay.process (juce::dsp::ProcessContextReplacing<float> (dryBlock));
+
+            auto oversampled = oversampling.processSamplesUp (block);
+
+            const juce::dsp::ProcessContextReplacing<float> context (oversampled);
+
+            if (useHighPass)
+                highPass.process (context);
+
+            if (useLowPass)
+                lowPass.process (context);
+
+            for (size_t channel = 0; channel < oversampled.getNumChannels(); ++channel)
+            {
+                auto* data = oversampled.getChannelPointer (channel);
+
+                for (size_t i = 0; i < oversampled.getNumSamples(); ++i)
+                {
+                    auto driven = data[i] * parameters.drive;
+
+                    if (distortionType == 5)
+                        driven = compressor.processSample ((int) channel, driven);
+
+                    data[i] = shapeBaselineSample (distortionType, driven);
+                }
+            }
+
+            oversampling.processSamplesDown (block);
+
+            for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            {
+                auto* data = block.getChannelPointer (channel);
+                const auto* clean = dryBlock.getChannelPointer (channel);
+
+                for (size_t i = 0; i < block.getNumSamples(); ++i)
+                    data[i] = (data[i] * mix + clean[i] * (1.0f - mix)) / makeupGain;    // Volume is 0dB throughout
+            }
+        }
+
+        return buffer;
+    }
+
+    /** The largest difference between two renders anywhere, in dB. */
+    float getNullResidual (const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& expected)
+    {
+        float maxDifference = 0.0f;
+
+        for (int channel = 0; channel < rendered.getNumChannels(); ++channel)
+        {
+            const auto* a = rendered.getReadPointer (channel);
+            const auto* b = expected.getReadPointer (channel);
+
+            for (int i = 0; i < rendered.getNumSamples(); ++i)
+                maxDifference = juce::jmax (maxDifference, std::abs (a[i] - b[i]));
+        }
+
+        return juce::Decibels::gainToDecibels (maxDifference, -200.0f);
+    }
+
+    bool writeWav (const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream (file.createOutputStream());
+
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release();    // Owned by the writer now
+        return writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    //==============================================================================
+    /** Hands visit blocks of floats that cover every magnitude a float can hold: the
+        positive bit patterns `stride` apart, each with its negative, up to the largest
+        finite float. That's a few million values from denormals to 3.4e38. */
+    template <typename Visitor>
+    void sweepFloatRange (Visitor&& visit)
+    {
+        constexpr juce::uint32 stride = 1021;
+        constexpr size_t chunkSize = 4096;
+        constexpr juce::uint32 infinityBits = 0x7f800000u;
+
+        std::vector<float> chunk;
+        chunk.reserve (chunkSize + 2);
+
+        for (juce::uint32 bits = 0; bits < infinityBits; bits += stride)
+        {
+            float x;
+            std::memcpy (&x, &bits, sizeof (x));
+            chunk.push_back (x);
+            chunk.push_back (-x);
+
+            if (chunk.size() >= chunkSize)
+            {
+                visit (chunk);
+                chunk.clear();
+            }
+        }
+
+        chunk.push_back (std::numeric_limits<float>::max());
+        chunk.push_back (-std::numeric_limits<float>::max());
+        visit (chunk);
+    }
+
+    /** The largest absolute difference between function, run through FastMath::apply
+        as the shaping loops run it, and reference, over the whole float range. Relative
+        to the reference when relative is set. */
+    template <typename Function, typename Reference>
+    double getMaxVectorError (Function&& function, Reference&& reference, bool relative = false)
+    {
+        double maxError = 0.0;
+        std::vector<float> output;
+
+        sweepFloatRange ([&] (const std::vector<float>& input)
+        {
+            output = input;
+            FastMath::apply (output.data(), output.size(), function);
+
+            for (size_t i = 0; i < input.size(); ++i)
+            {
+                const auto expected = (double) reference (input[i]);
+                const auto error = std::abs ((double) output[i] - expected);
+                maxError = juce::jmax (maxError, relative ? error / std::abs (expected) : error);
+            }
+        });
+
+        return maxError;
+    }
+
+    template <Distortion::Mode mode>
+    double getMaxKernelError()
+    {
+        return getMaxVectorError ([] (auto x) { return Distortion::Kernel<mode>::processSampleFast (x); },
+                                  [] (float x) { return Distortion::Kernel<mode>::processSample (x); });
+    }
+
+    template <Distortion::Mode mode, CurveTable::Interpolation interpolation>
+    double getMaxTableError()
+    {
+        auto table = std::make_unique<CurveTable>();
+        table->build (&Distortion::Kernel<mode>::processSample);
+        double maxError = 0.0;
+
+        for (int i = -500000; i <= 500000; ++i)
+        {
+            const auto x = (float) i * 1.0e-4f;
+            const auto error = std::abs ((double) table->processSample<interpolation> (x)
+                                       - (double) Distortion::Kernel<mode>::processSample (x));
+            maxError = juce::jmax (maxError, error);
+        }
+
+        return maxError;
+    }
+}
+
+//==============================================================================
+int RegressionSuite::renderReferences (const juce::File& directory, std::ostream& report)
+{
+    directory.createDirectory();
+    int numFailures = 0;
+
+    forEachCase ([&] (const juce::String& name, const juce::AudioBuffer<float>& buffer)
+    {
+        if (! writeWav (directory.getChildFile (name), buffer))
+        {
+            report << "FAILED to write " << name << std::endl;
+            ++numFailures;
+        }
+    });
+
+    return numFailures;
+}
+
+int RegressionSuite::verify (const juce::File& directory, double toleranceDecibels, std::ostream& report)
+{
+    // Without references every case would be skipped, which must not read as a pass
+    if (! directory.isDirectory() || directory.findChildFiles (juce::File::findFiles, false, "*.wav").isEmpty())
+    {
+        report << "No references in " << directory.getFullPathName() << ", render them with --render-references"
+               << " from the build to compare against, or use --verify-baseline" << std::endl;
+        return getTestSignals().size() * getParameterSets().size() * 5;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    int numFailures = 0;
+
+    report << "case,residual_db,result" << std::endl;
+
+    forEachCase ([&] (const juce::String& name, const juce::AudioBuffer<float>& buffer)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (directory.getChildFile (name)));
+
+        if (reader == nullptr || (int) reader->numChannels != buffer.getNumChannels()
+             || reader->lengthInSamples != buffer.getNumSamples())
+        {
+            report << name << ",,MISSING" << std::endl;
+            ++numFailures;
+            return;
+        }
+
+        juce::AudioBuffer<float> reference (buffer.getNumChannels(), buffer.getNumSamples());
+        reader->read (&reference, 0, buffer.getNumSamples(), 0, true, true);
+
+        const auto residual = getNullResidual (buffer, reference);
+        const auto passed = residual <= toleranceDecibels;
+
+        report << name << "," << residual << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+        if (! passed)
+            ++numFailures;
+    });
+
+    return numFailures;
+}
+
+int RegressionSuite::verifyAgainstBaseline (double toleranceDecibels, std::ostream& report)
+{
+    // Every case --verify renders, so a fresh checkout has the whole set covered without
+    // any reference files
+    int numFailures = 0;
+
+    report << "case,residual_db,result" << std::endl;
+
+    for (auto& signal : getTestSignals())
+    {
+        for (auto& parameters : getParameterSets())
+        {
+            for (int distortionType = 1; distortionType <= 5; ++distortionType)
+            {
+                const auto residual = getNullResidual (render (signal, parameters, distortionType),
+                                                       renderBaseline (signal, parameters, distortionType));
+                const auto passed = residual <= toleranceDecibels;
+
+                report << signal.name << "_" << parameters.name << "_mode" << distortionType << ","
+                       << residual << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+                if (! passed)
+                    ++numFailures;
+            }
+        }
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::measureAliasing (std::ostream& output)
+{
+    constexpr int fftOrder = 14;
+    constexpr int fftSize = 1 << fftOrder;
+
+    // The test tone sits exactly on a bin, and each harmonic window spans the window's main lobe
+    constexpr int fundamentalBin = 1700;
+    constexpr int lobeBins = 4;
+    const auto frequency = fundamentalBin * sampleRate / fftSize;
+
+    juce::dsp::FFT fft (fftOrder);
+    juce::dsp::WindowingFunction<float> window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+
+    const TestSignal tone { "tone", [frequency] (int i)
+    {
+        return 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+    } };
+
+    const ParameterSet parameters { "aliasing", 10.0f, 100.0f, 20.0f, 20000.0f, false };
+
+    // The most folded-back energy each oversampling factor may let through, per antialiasing
+    // setting, about 10dB above what ideal resampling filters measure for the worst curve.
+    // softClip has no antiderivative, so it's held to its own limit whatever the setting.
+    // Nothing is asked below -50dBc, where the IIR halfbands' own leakage takes over.
+    struct Limits { double off, firstOrder, secondOrder, softClip; };
+
+    const Limits limits[] = {
+        { -5.0,  -10.0, -15.0, -3.0  },    // 1x
+        { -25.0, -40.0, -50.0, -16.0 },    // 2x
+        { -35.0, -50.0, -50.0, -36.0 },    // 4x
+        { -50.0, -50.0, -50.0, -50.0 },    // 8x
+        { -50.0, -50.0, -50.0, -50.0 }     // 16x
+    };
+
+    int numFailures = 0;
+    output << "oversampling,antialiasing,mode,thd_n_db,aliasing_dbc,limit_dbc,result" << std::endl;
+
+    for (int oversamplingIndex = 0; oversamplingIndex < 5; ++oversamplingIndex)
+    {
+        for (int antialiasing = 0; antialiasing < Distortion::getAntialiasingNames().size(); ++antialiasing)
+        {
+            for (int distortionType = 1; distortionType <= 5; ++distortionType)
+            {
+                const auto buffer = render (tone, parameters, distortionType, oversamplingIndex, antialiasing);
+
+                // Analyse the steady state at the end of the render
+                std::vector<float> data ((size_t) fftSize * 2, 0.0f);
+                std::copy_n (buffer.getReadPointer (0, renderLength - fftSize), fftSize, data.begin());
+                window.multiplyWithWindowingTable (data.data(), (size_t) fftSize);
+                fft.performFrequencyOnlyForwardTransform (data.data());
+
+                double fundamental = 0.0, harmonics = 0.0, other = 0.0;
+
+                for (int bin = lobeBins + 1; bin <= fftSize / 2; ++bin)
+                {
+                    const auto power = (double) data[(size_t) bin] * data[(size_t) bin];
+                    const auto harmonic = juce::roundToInt ((double) bin / fundamentalBin);
+                    const auto isHarmonic = harmonic >= 1 && std::abs (bin - harmonic * fundamentalBin) <= lobeBins;
+
+                    if (isHarmonic && harmonic == 1)
+                        fundamental += power;
+                    else if (isHarmonic)
+                        harmonics += power;
+                    else
+                        other += power;    // Noise, and harmonics folded back from above Nyquist
+                }
+
+                const auto thdPlusNoise = 10.0 * std::log10 ((harmonics + other) / fundamental);
+                const auto aliasing = 10.0 * std::log10 (juce::jmax (other, 1.0e-30) / fundamental);
+
+                const auto& limit = limits[oversamplingIndex];
+                const auto limitDecibels = Distortion::modeFromParameter ((float) distortionType) == Distortion::Mode::softClip ? limit.softClip
+                                         : antialiasing == 0 ? limit.off
+                                         : antialiasing == 1 ? limit.firstOrder
+                                                             : limit.secondOrder;
+                const auto passed = aliasing <= limitDecibels;
+
+                output << (1 << oversamplingIndex) << "x," << antialiasing << "," << distortionType << ","
+                       << thdPlusNoise << "," << aliasing << "," << limitDecibels << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+                if (! passed)
+                    ++numFailures;
+            }
+        }
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::checkKernelAccuracy (std::ostream& report)
+{
+    using Distortion::Mode;
+    using Interpolation = CurveTable::Interpolation;
+
+    // The FastMath functions against double precision, at exactly their stated bounds. The
+    // kernels get those bounds scaled by each curve's output gain, plus float rounding slack.
+    // The tables are held to -60dB, which only the hard clip's kink comes near.
+    struct Check { const char* name; double error; double bound; };
+    constexpr double tableBound = 1.0e-3;
+    constexpr float smallestNormal = std::numeric_limits<float>::min();
+
+    const Check checks[] = {
+        { "expMinusAbs", getMaxVectorError ([] (auto x) { return FastMath::expMinusAbs (x); },
+                                            [] (float x) { return std::exp (-std::abs ((double) x)); }), 1.0e-6 },
+        { "atan",        getMaxVectorError ([] (auto x) { return FastMath::atan (x); },
+                                            [] (float x) { return std::atan ((double) x); }),            2.0e-6 },
+
+        // log2 and exp2 only take part of the range, so the sweep is folded into it
+        { "log2",        getMaxVectorError ([] (auto x) { using Value = decltype (x);
+                                                          return FastMath::log2 (FastMath::max (FastMath::abs (x), Value (smallestNormal))); },
+                                            [] (float x) { return std::log2 (juce::jmax ((double) std::abs (x), (double) smallestNormal)); }), 8.0e-6 },
+        { "exp2",        getMaxVectorError ([] (auto x) { return FastMath::exp2 (x); },
+                                            [] (float x) { return std::exp2 (juce::jlimit (-126.0, 127.0, (double) x)); }, true), 2.0e-7 },
+
+        // DynamicsStage's gain curve at 4:1, relative to the exact gain
+        { "gainCurve",   getMaxVectorError ([] (auto x) { using Value = decltype (x);
+                                                          return FastMath::exp2 (Value (-0.75f) * FastMath::log2 (FastMath::max (Value (1.0f), FastMath::abs (x)))); },
+                                            [] (float x) { return std::pow (juce::jmax (1.0, (double) std::abs (x)), -0.75); }, true), 6.0e-6 },
+
+        { "hardClip",    getMaxKernelError<Mode::hardClip>(),    1.0e-7 },
+        { "softClip",    getMaxKernelError<Mode::softClip>(),    1.0e-7 },
+        { "exponential", getMaxKernelError<Mode::exponential>(), 1.5 * 1.0e-6 + 1.0e-7 },
+        { "arcTan",      getMaxKernelError<Mode::arcTan>(),      2.0 / juce::MathConstants<double>::pi * 2.0e-6 + 1.0e-7 },
+        { "tubeIsh",     getMaxKernelError<Mode::tubeIsh>(),     1.0e-7 },
+
+        { "table_hardClip_linear",    getMaxTableError<Mode::hardClip,    Interpolation::linear>(), tableBound },
+        { "table_hardClip_cubic",     getMaxTableError<Mode::hardClip,    Interpolation::cubic>(),  tableBound },
+        { "table_softClip_linear",    getMaxTableError<Mode::softClip,    Interpolation::linear>(), tableBound },
+        { "table_softClip_cubic",     getMaxTableError<Mode::softClip,    Interpolation::cubic>(),  tableBound },
+        { "table_exponential_linear", getMaxTableError<Mode::exponential, Interpolation::linear>(), tableBound },
+        { "table_exponential_cubic",  getMaxTableError<Mode::exponential, Interpolation::cubic>(),  tableBound },
+        { "table_arcTan_linear",      getMaxTableError<Mode::arcTan,      Interpolation::linear>(), tableBound },
+        { "table_arcTan_cubic",       getMaxTableError<Mode::arcTan,      Interpolation::cubic>(),  tableBound },
+        { "table_tubeIsh_linear",     getMaxTableError<Mode::tubeIsh,     Interpolation::linear>(), tableBound },
+        { "table_tubeIsh_cubic",      getMaxTableError<Mode::tubeIsh,     Interpolation::cubic>(),  tableBound }
+    };
+
+    int numFailures = 0;
+    report << "kernel,max_error,bound,result" << std::endl;
+
+    for (auto& check : checks)
+    {
+        const auto passed = check.error <= check.bound;
+        report << check.name << "," << check.error << "," << check.bound << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+        if (! passed)
+            ++numFailures;
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::checkAntialiasingSwitches (std::ostream& report)
+{
+    // A slow sine driven well into every curve, with the antialiasing order changing every
+    // block and the mode every three, so each order meets each curve's leftover history.
+    // ADAA averages the curve between inputs, so nothing may ever leave the curve's range:
+    // the larger of the two ranges while a mode change crossfades.
+    constexpr int numBlocks = 3000;
+    constexpr int shaperBlockSize = 128;
+    constexpr double frequency = 5.0;
+
+    Waveshaper waveshaper;
+    waveshaper.prepare ({ sampleRate, (juce::uint32) shaperBlockSize, (juce::uint32) numChannels });
+    waveshaper.setDrive (4.0f);
+
+    const auto getRange = [] (Distortion::Mode mode) { return std::abs (Distortion::shapeSample (mode, 1.0e6f)); };
+
+    // Peak and limit per incoming mode and order
+    float peaks[5][3] = {}, limits[5][3] = {};
+
+    juce::AudioBuffer<float> buffer (numChannels, shaperBlockSize);
+    auto previousMode = Distortion::Mode::hardClip;
+
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+    {
+        const auto mode = Distortion::modeFromParameter ((float) (1 + (blockIndex / 3) % 5));
+        const auto antialiasing = blockIndex % 3;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < shaperBlockSize; ++i)
+                buffer.setSample (channel, i, (float) std::sin (juce::MathConstants<double>::twoPi * frequency
+                                                                 * (blockIndex * shaperBlockSize + i) / sampleRate));
+
+        waveshaper.setMode (mode);
+        waveshaper.setAntialiasing (static_cast<Distortion::Antialiasing> (antialiasing));
+
+        juce::dsp::AudioBlock<float> block (buffer);
+        waveshaper.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+        const auto index = static_cast<int> (mode) - 1;
+        auto& peak = peaks[index][antialiasing];
+        auto& limit = limits[index][antialiasing];
+        limit = juce::jmax (limit, getRange (mode), getRange (previousMode));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            peak = juce::jmax (peak, buffer.getMagnitude (channel, 0, shaperBlockSize));
+
+        previousMode = mode;
+    }
+
+    int numFailures = 0;
+    report << "mode,antialiasing,peak,limit,result" << std::endl;
+
+    for (int mode = 0; mode < 5; ++mode)
+    {
+        for (int antialiasing = 0; antialiasing < 3; ++antialiasing)
+        {
+            // Float rounding of the double results, nothing more
+            const auto passed = peaks[mode][antialiasing] <= limits[mode][antialiasing] + 1.0e-5f;
+
+            report << (mode + 1) << "," << antialiasing << "," << peaks[mode][antialiasing] << ","
+                   << limits[mode][antialiasing] << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+            if (! passed)
+                ++numFailures;
+        }
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::checkOversamplingSwitches (std::ostream& report)
+{
+    using ProcessorHelpers::setParameter;
+
+    // A slow sine, driven and mixed half dry so the filters, the shaper's history and the
+    // dry path's alignment all have to carry across. The factor and filter quality move
+    // every few blocks through every combination. A switch that jumps any of them shows up
+    // as a spike in the second difference, far above anything the steady renders reach.
+    constexpr int blocksPerSetting = 4;
+    constexpr int numSettings = OversamplingStage::numFactors * 2;
+    constexpr int settleSamples = 8192;
+    constexpr float limitFactor = 4.0f;
+
+    const TestSignal tone { "tone", [] (int i)
+    {
+        return 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * 50.0 * i / sampleRate);
+    } };
+
+    const ParameterSet parameters { "switching", 2.0f, 50.0f, 20.0f, 20000.0f, false };
+
+    const auto getMaxSecondDifference = [] (const juce::AudioBuffer<float>& buffer, int start)
+    {
+        float maxDifference = 0.0f;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const auto* data = buffer.getReadPointer (channel);
+
+            for (int i = juce::jmax (2, start); i < buffer.getNumSamples(); ++i)
+                maxDifference = juce::jmax (maxDifference, std::abs (data[i] - 2.0f * data[i - 1] + data[i - 2]));
+        }
+
+        return maxDifference;
+    };
+
+    int numFailures = 0;
+    report << "mode,steady,switching,limit,result" << std::endl;
+
+    for (auto distortionType : { 3, 5 })
+    {
+        // The worst the output does at any one setting, once settled
+        float steady = 0.0f;
+
+        for (int setting = 0; setting < numSettings; ++setting)
+        {
+            juce::AudioBuffer<float> buffer (numChannels, renderLength);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < renderLength; ++i)
+                    buffer.setSample (channel, i, tone.generate (i));
+
+            auto processor = createProcessor (parameters, distortionType, setting % OversamplingStage::numFactors, 0);
+            setParameter (*processor, "OVERSAMPLINGFILTER", (float) (setting / OversamplingStage::numFactors));
+            processor->prepareToPlay (sampleRate, blockSize);
+            ProcessorHelpers::render (*processor, buffer, blockSize);
+            steady = juce::jmax (steady, getMaxSecondDifference (buffer, settleSamples));
+        }
+
+        juce::AudioBuffer<float> buffer (numChannels, renderLength);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < renderLength; ++i)
+                buffer.setSample (channel, i, tone.generate (i));
+
+        auto processor = createProcessor (parameters, distortionType, 2, 0);
+        juce::MidiBuffer midi;
+
+        for (int start = 0, block = 0; start < renderLength; start += blockSize, ++block)
+        {
+            // Steps through the factors at one quality, then back down at the other
+            if (start >= settleSamples && block % blocksPerSetting == 0)
+            {
+                const auto setting = (block / blocksPerSetting) % numSettings;
+                const auto quality = setting / OversamplingStage::numFactors;
+                const auto factorIndex = quality == 0 ? setting % OversamplingStage::numFactors
+                                                      : OversamplingStage::numFactors - 1 - setting % OversamplingStage::numFactors;
+                setParameter (*processor, "OVERSAMPLING", (float) factorIndex);
+                setParameter (*processor, "OVERSAMPLINGFILTER", (float) quality);
+            }
+
+            juce::AudioBuffer<float> hostBlock (buffer.getArrayOfWritePointers(), numChannels, start, juce::jmin (blockSize, renderLength - start));
+            processor->processBlock (hostBlock, midi);
+        }
+
+        const auto switching = getMaxSecondDifference (buffer, settleSamples);
+        const auto limit = steady * limitFactor;
+        const auto passed = switching <= limit;
+
+        report << distortionType << "," << steady << "," << switching << "," << limit << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+        if (! passed)
+            ++numFailures;
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::checkBlockSizeIndependence (double toleranceDecibels, std::ostream& report)
+{
+    // Host block patterns, each one repeated over the whole render. The processor cuts
+    // them all onto the same internal grid, so they should all null against each other.
+    struct Pattern { const char* name; juce::Array<int> sizes; };
+
+    const Pattern patterns[] = {
+        { "16",       { 16 } },
+        { "100",      { 100 } },
+        { "128",      { 128 } },
+        { "8192",     { 8192 } },
+        { "variable", { 37, 512, 3, 200, 1024, 64 } }
+    };
+
+    const auto signal = getTestSignals()[4];
+    const auto parameters = getParameterSets()[1];
+
+    int numFailures = 0;
+    report << "mode,blocks,residual_db,result" << std::endl;
+
+    for (int distortionType = 1; distortionType <= 5; ++distortionType)
+    {
+        const auto reference = render (signal, parameters, distortionType);
+
+        for (auto& pattern : patterns)
+        {
+            juce::AudioBuffer<float> buffer (numChannels, renderLength);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < renderLength; ++i)
+                    buffer.setSample (channel, i, signal.generate (i));
+
+            auto processor = createProcessor (parameters, distortionType, 2, 0);
+            juce::MidiBuffer midi;
+
+            for (int start = 0, block = 0; start < renderLength; ++block)
+            {
+                const auto length = juce::jmin (pattern.sizes[block % pattern.sizes.size()], renderLength - start);
+                juce::AudioBuffer<float> hostBlock (buffer.getArrayOfWritePointers(), numChannels, start, length);
+                processor->processBlock (hostBlock, midi);
+                start += length;
+            }
+
+            float maxDifference = 0.0f;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < renderLength; ++i)
+                    maxDifference = juce::jmax (maxDifference, std::abs (buffer.getSample (channel, i) - reference.getSample (channel, i)));
+
+            const auto residual = juce::Decibels::gainToDecibels (maxDifference, -200.0f);
+            const auto passed = residual <= toleranceDecibels;
+
+            report << distortionType << "," << pattern.name << "," << residual << "," << (passed ? "PASS" : "FAIL") << std::endl;
+
+            if (! passed)
+                ++numFailures;
+        }
+    }
+
+    return numFailures;
+}
+
+int RegressionSuite::checkRealtimeSafety (std::ostream& report)
+{
+    using ProcessorHelpers::setParameter;
+
+    if (! RealtimeSafety::isEnabled())
+    {
+        report << "Realtime safety hooks aren't compiled in, build with DEETZ_REALTIME_SAFETY_CHECKS=1" << std::endl;
+        return 1;
+    }
+
+    // Count rather than abort, so one run reports every path that fails
+    RealtimeSafety::setAbortOnViolation (false);
+
+    // Each setting is stepped through between blocks the way automation would move it,
+    // in tubeIsh so the dynamics run too
+    struct Case { const char* parameterID; juce::Array<float> values; };
+
+    const Case cases[] = {
+        { "DISTORTIONTYPE",     { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f } },
+        { "OVERSAMPLING",       { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f } },
+        { "OVERSAMPLINGFILTER", { 0.0f, 1.0f } },
+        { "ANTIALIASING",       { 0.0f, 1.0f, 2.0f } },
+        { "SHAPERENGINE",       { 0.0f, 1.0f, 2.0f, 3.0f } },
+        { "FILTERPLACEMENT",    { 0.0f, 1.0f, 2.0f, 3.0f } },
+        { "COMPRATE",           { 0.0f, 1.0f } },
+        { "COMPLINK",           { 0.0f, 1.0f, 2.0f } },
+        { "MULTIBAND",          { 0.0f, 1.0f, 2.0f, 3.0f } },
+        { "DRYWET",             { 100.0f, 1.0f, 50.0f } },
+        { "MORPHENABLE",        { 1.0f, 0.0f } }
+    };
+
+    juce::Random random (1);
+    juce::MidiBuffer midi;
+
+    // The last block of each case is bigger than the prepared size, which the processor has to split up
+    juce::AudioBuffer<float> block (numChannels, blockSize), oversizedBlock (numChannels, blockSize * 4);
+
+    int numFailures = 0;
+    report << "parameter,violations,result" << std::endl;
+
+    for (auto& check : cases)
+    {
+        auto processor = createProcessor (getParameterSets()[1], 5, 2, 0);
+        const auto violationsBefore = RealtimeSafety::getNumViolations();
+
+        for (auto value : check.values)
+        {
+            setParameter (*processor, check.parameterID, value);
+            ProcessorHelpers::fillWithNoise (block, random, 0.5f);
+            processor->processBlock (block, midi);
+        }
+
+        ProcessorHelpers::fillWithNoise (oversizedBlock, random, 0.5f);
+        processor->processBlock (oversizedBlock, midi);
+        processor->processBlockBypassed (oversizedBlock, midi);
+
+        const auto violations = RealtimeSafety::getNumViolations() - violationsBefore;
+        report << check.parameterID << "," << violations << "," << (violations == 0 ? "PASS" : "FAIL") << std::endl;
+
+        if (violations > 0)
+            ++numFailures;
+    }
+
+    RealtimeSafety::setAbortOnViolation (true);
+    return numFailures;
+}
+
+//==============================================================================
+int RegressionSuite::checkStateRecall (std::ostream& report)
+{
+    constexpr int numLoads = 200;
+
+    // Every parameter somewhere away from its default, plus a custom curve
+    DeetzStortionAPVTSAudioProcessor source;
+    juce::Random random (7);
+
+    for (auto* parameter : source.getParameters())
+        parameter->setValueNotifyingHost (random.nextFloat());
+
+    source.setCustomCurve ({ { -1.0f, -0.8f }, { 0.0f, 0.0f }, { 0.5f, 0.7f }, { 1.0f, 0.9f } });
+    source.getSnapshots().capture (1);
+
+    juce::MemoryBlock binaryState, legacyState;
+    source.getStateInformation (binaryState);
+
+    // What versions before the binary format saved
+    if (auto xml = source.apvts.copyState().createXml())
+        juce::AudioProcessor::copyXmlToBinary (*xml, legacyState);
+
+    // Legacy XML predates the snapshots, so only the binary state is expected to carry them
+    auto countMismatches = [&source] (DeetzStortionAPVTSAudioProcessor& loaded, bool checkSnapshots)
+    {
+        int numMismatches = 0;
+        const auto& expected = source.getParameters();
+        const auto& actual = loaded.getParameters();
+
+        for (int i = 0; i < expected.size(); ++i)
+            if (std::abs (expected[i]->getValue() - actual[i]->getValue()) > 1.0e-5f)
+                ++numMismatches;
+
+        if (loaded.getCustomCurve() != source.getCustomCurve())
+            ++numMismatches;
+
+        if (checkSnapshots)
+        {
+            const auto expectedSnapshot = source.getSnapshots().getSnapshotValues (1);
+            const auto actualSnapshot = loaded.getSnapshots().getSnapshotValues (1);
+
+            if (actualSnapshot.size() != expectedSnapshot.size())
+                ++numMismatches;
+            else
+                for (size_t i = 0; i < expectedSnapshot.size(); ++i)
+                    if (std::abs (expectedSnapshot[i] - actualSnapshot[i]) > 1.0e-3f * juce::jmax (1.0f, std::abs (expectedSnapshot[i])))
+                        ++numMismatches;
+        }
+
+        return numMismatches;
+    };
+
+    int numFailures = 0;
+    report << "format,bytes,mismatches,us_per_load,result" << std::endl;
+
+    for (auto* state : { &binaryState, &legacyState })
+    {
+        DeetzStortionAPVTSAudioProcessor loaded;
+        loaded.setStateInformation (state->getData(), (int) state->getSize());
+        const auto mismatches = countMismatches (loaded, state == &binaryState);
+
+        // Alternating with the defaults, so every load really changes every value
+        juce::MemoryBlock defaults;
+        DeetzStortionAPVTSAudioProcessor().getStateInformation (defaults);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numLoads; ++i)
+        {
+            const auto& next = i % 2 == 0 ? defaults : *state;
+            loaded.setStateInformation (next.getData(), (int) next.getSize());
+        }
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+        report << (state == &binaryState ? "binary" : "legacy xml") << "," << state->getSize() << "," << mismatches << ","
+               << seconds * 1.0e6 / numLoads << "," << (mismatches == 0 ? "PASS" : "FAIL") << std::endl;
+
+        if (mismatches > 0)
+            ++numFailures;
+    }
+
+    return numFailures;
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    RegressionSuite.h
+    Created: 17 Oct 2026
+    Author:  deetz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Golden-output checks for the DSP, run headlessly from the benchmark harness.
+
+    - renderReferences() renders sines, a sweep, an impulse and noise through every
+      DISTORTIONTYPE under a few parameter sets and writes them as 32-bit float WAVs.
+    - verify() renders the same set again and null-tests it against a reference
+      directory, failing any render whose residual is above the tolerance, and every
+      render if the directory holds no references at all.
+    - verifyAgainstBaseline() needs no files: it null-tests every case verify() renders
+      against the original release's chain, kept frozen in the suite, with the changes
+      the rewrite made on purpose written into it.
+    - measureAliasing() reports THD+N and the level of folded-back (non-harmonic)
+      energy for every oversampling and antialiasing setting and mode, and fails any
+      above that setting's limit.
+    - checkKernelAccuracy() sweeps the whole float range through FastMath's functions
+      and every mode's vectorised kernel, holding them to FastMath's stated error
+      bounds against the std:: references, and holds the curve tables to -60dB.
+    - checkAntialiasingSwitches() switches the shaper's mode and ADAA order under a
+      slow sine and fails if the output ever leaves the curves' range.
+    - checkOversamplingSwitches() steps the oversampling factor and filter quality
+      through every setting under a slow, half dry sine, and fails if a switch makes
+      the output jump well beyond what any one setting does on its own.
+    - checkBlockSizeIndependence() renders with host blocks from 16 to 8192 samples,
+      and with a varying pattern, and null-tests each against the 512-sample render.
+    - checkRealtimeSafety() automates every setting while processing and fails any
+      that allocates or locks on the audio thread, including host blocks bigger than
+      the prepared size. Needs a build with DEETZ_REALTIME_SAFETY_CHECKS=1.
+    - checkStateRecall() round-trips every parameter, the custom curve and a morph
+      snapshot through the binary state, migrates the same state saved as legacy XML,
+      and times both loads.
+
+    Each check returns the number of failures, so main() can turn it into an exit code.
+*/
+namespace RegressionSuite
+{
+    int renderReferences (const juce::File& directory, std::ostream& report);
+    int verify (const juce::File& directory, double toleranceDecibels, std::ostream& report);
+    int verifyAgainstBaseline (double toleranceDecibels, std::ostream& report);
+    int measureAliasing (std::ostream& output);
+    int checkKernelAccuracy (std::ostream& report);
+    int checkAntialiasingSwitches (std::ostream& report);
+    int checkOversamplingSwitches (std::ostream& report);
+    int checkBlockSizeIndependence (double toleranceDecibels, std::ostream& report);
+    int checkRealtimeSafety (std::ostream& report);
+    int checkStateRecall (std::ostream& report);
+}